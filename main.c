@@ -2,10 +2,13 @@
 
 #include <glib.h>
 #include <glib-object.h>
+#include <signal.h>
 #include <string.h>
 
 #include "waybar_mediaplayer.h"
 #include "media_controller.h"
+#include "media_watchdog.h"
+#include "media_timeline.h"
 
 
 // This static variable is shared between all instances of this module
@@ -40,6 +43,21 @@ replace_unicode_escapes(const gchar* input) {
     return g_string_free_and_steal(result);
 }
 
+// Config values arrive as JSON, drop the surrounding quotes and unescape
+// the inner ones
+static gchar*
+strip_json_string(const gchar* input) {
+  gsize len = strlen(input);
+  if(len >= 2 && input[0] == '"' && input[len-1] == '"'){
+    input++;
+    len -= 2;
+  }
+
+  GString* result = g_string_new_len(input, len);
+  g_string_replace(result, "\\\"", "\"", 0);
+  return g_string_free(result, FALSE);
+}
+
 static gchar* replace_string_glib(const gchar* input, const gchar* find, const gchar* replace) {
     // Create GString from gchar*
     GString* gstr = g_string_new(input);
@@ -57,6 +75,8 @@ wbcffi_init(const wbcffi_init_info* init_info, const wbcffi_config_entry* config
   
   g_info("waybar_mediapliayer initialized");
 
+  media_timeline_begin();
+
   MediaPlayerModConfig* config = g_malloc(sizeof(MediaPlayerModConfig));
   config->scroll_title = TRUE;
   config->title_max_width = 200;
@@ -71,6 +91,18 @@ wbcffi_init(const wbcffi_init_info* init_info, const wbcffi_config_entry* config
   config->btn_prev = g_strdup("");
   config->btn_next = g_strdup("");
   config->ignored_players = g_strdup("");
+  config->watchdog_threshold = 0;
+  config->title_format = g_strdup(MEDIA_TITLE_FORMAT_DEFAULT);
+  config->title_template = NULL;
+  for(guint i = 0; i < MEDIA_TITLE_FIELD_LAST; i++) config->title_styles[i] = NULL;
+  config->title_ellipsize = TITLE_ELLIPSIZE_NONE;
+  config->time_format = TIME_FORMAT_NONE;
+  config->player_icon = FALSE;
+  config->player_icon_size = 16;
+  config->seek_step = 5;
+  config->volume_step = 5;
+  config->instance = instance_count;
+  config->signal = -1;
 
   for (size_t i = 0; i < config_entries_len; i++) {
     if(strncasecmp("scroll-before-timeout", config_entries[i].key,21)==0){
@@ -109,6 +141,55 @@ wbcffi_init(const wbcffi_init_info* init_info, const wbcffi_config_entry* config
     } else if(strncasecmp("btn-prev-icon", config_entries[i].key,13)==0){
       g_free(config->btn_prev);
       config->btn_prev = replace_unicode_escapes(config_entries[i].value); 
+    } else if(strncasecmp("watchdog-threshold", config_entries[i].key,18)==0){
+      config->watchdog_threshold = g_ascii_strtoull(config_entries[i].value, NULL, 10);
+    } else if(strncasecmp("title-format", config_entries[i].key,12)==0){
+      g_free(config->title_format);
+      config->title_format = strip_json_string(config_entries[i].value);
+    } else if(strncasecmp("title-ellipsize", config_entries[i].key,15)==0){
+      gchar* mode = strip_json_string(config_entries[i].value);
+      if(g_ascii_strcasecmp(mode, "end") == 0){
+        config->title_ellipsize = TITLE_ELLIPSIZE_END;
+      } else if(g_ascii_strcasecmp(mode, "middle") == 0){
+        config->title_ellipsize = TITLE_ELLIPSIZE_MIDDLE;
+      } else {
+        config->title_ellipsize = TITLE_ELLIPSIZE_NONE;
+      }
+      g_free(mode);
+    } else if(strncasecmp("volume-step", config_entries[i].key,11)==0){
+      config->volume_step = g_ascii_strtoull(config_entries[i].value, NULL, 10);
+    } else if(strncasecmp("seek-step", config_entries[i].key,9)==0){
+      config->seek_step = g_ascii_strtoull(config_entries[i].value, NULL, 10);
+    } else if(strncasecmp("player-icon-size", config_entries[i].key,16)==0){
+      config->player_icon_size = g_ascii_strtoull(config_entries[i].value, NULL, 10);
+    } else if(strncasecmp("player-icon", config_entries[i].key,11)==0){
+      if(strncasecmp("true", config_entries[i].value,4)==0){
+        config->player_icon = TRUE;
+      } else {
+        config->player_icon = FALSE;
+      }
+    } else if(strncasecmp("time-format", config_entries[i].key,11)==0){
+      gchar* format = strip_json_string(config_entries[i].value);
+      if(g_ascii_strcasecmp(format, "elapsed") == 0){
+        config->time_format = TIME_FORMAT_ELAPSED;
+      } else if(g_ascii_strcasecmp(format, "remaining") == 0){
+        config->time_format = TIME_FORMAT_REMAINING;
+      } else {
+        config->time_format = TIME_FORMAT_NONE;
+      }
+      g_free(format);
+    } else if(strncasecmp("style-", config_entries[i].key,6)==0){
+      const gchar* name = config_entries[i].key + 6;
+      MediaTitleField field = media_title_format_field_from_name(name, strlen(name));
+
+      if(field == MEDIA_TITLE_FIELD_LAST){
+        g_warning("Property '%s' ignored", config_entries[i].key);
+      } else {
+        g_free(config->title_styles[field]);
+        config->title_styles[field] = strip_json_string(config_entries[i].value);
+      }
+    } else if(strncasecmp("signal", config_entries[i].key,6)==0){
+      config->signal = g_ascii_strtoll(config_entries[i].value, NULL, 10);
     } else if(strncasecmp("ignored-players", config_entries[i].key,15)==0){
       g_free(config->ignored_players);
 
@@ -123,13 +204,21 @@ wbcffi_init(const wbcffi_init_info* init_info, const wbcffi_config_entry* config
     }
   }
 
+  config->title_template = media_title_format_compile(config->title_format);
+
+  media_timeline_mark(MEDIA_TIMELINE_CONFIG);
+
+  media_watchdog_set_threshold(config->watchdog_threshold);
+
   // Allocate the instance object
   MediaPlayerMod* inst = malloc(sizeof(MediaPlayerMod));
   inst->waybar_module = init_info->obj;
+  inst->signal = config->signal;
 
   GtkContainer* root = init_info->get_root_widget(init_info->obj);
 
   inst->container = gtk_media_controller_new(config);
+  media_timeline_mark(MEDIA_TIMELINE_CONTROLLER);
   gtk_container_add(GTK_CONTAINER(root), GTK_WIDGET(inst->container));
 
   // Return instance object
@@ -140,6 +229,17 @@ wbcffi_init(const wbcffi_init_info* init_info, const wbcffi_config_entry* config
 void 
 wbcffi_deinit(void* instance) {
   g_info("waybar_mediaplayer inst=%p: free memory\n", instance);
+
+  MediaPlayerMod* inst = instance;
+
+  // Drops the root widget's reference, the controller takes its manager,
+  // players, timers and bus subscriptions with it
+  if(inst->container){
+    gtk_widget_destroy(GTK_WIDGET(inst->container));
+    inst->container = NULL;
+  }
+
+  instance_count--;
   free(instance);
 }
 
@@ -148,9 +248,20 @@ wbcffi_update(void* instance) { printf("waybar_mediaplayer inst=%p: Update reque
 
 void 
 wbcffi_refresh(void* instance, int signal) {
+  MediaPlayerMod* inst = instance;
+
+  // Waybar hands every real-time signal to every module, only the one
+  // configured for this module dumps the runtime counters
+  if(inst->signal < 0 || signal != SIGRTMIN + inst->signal) return;
+
+  gtk_media_controller_dump_stats(inst->container);
 }
 
 void 
 wbcffi_doaction(void* instance, const char* name) {
-  printf("waybar_mediaplayer inst=%p: doAction(%s)\n", instance, name);
+  MediaPlayerMod* inst = instance;
+
+  if(!gtk_media_controller_do_action(inst->container, name)){
+    g_warning("waybar_mediaplayer inst=%p: unknown action %s", instance, name);
+  }
 }
@@ -25,11 +25,27 @@
 #include <pango/pango.h>
 #include <glib-object.h>
 #include <glib.h>
+#include <string.h>
 
 #include "media_controller.h"
 
 #include "mpris_media_manager.h"
 #include "mpris_media_player.h"
+#include "media_snapshot.h"
+#include "media_view_model.h"
+#include "media_icon_cache.h"
+#include "mpris_track_list.h"
+#include "media_stats.h"
+#include "media_trace.h"
+#include "media_watchdog.h"
+#include "media_timeline.h"
+#include "media_title_style.h"
+
+// Pixels above the bottom edge where a click seeks instead of reaching the
+// widget below, the progress line itself is 2 pixels high
+#define PROGRESS_HIT_HEIGHT 4
+// How long the volume stays shown after the last scroll
+#define VOLUME_LABEL_TIMEOUT_MS 1500
 
 struct _GtkMediaController
 {
@@ -38,25 +54,69 @@ struct _GtkMediaController
   MediaPlayerModConfig* config;
   gboolean reversed_scroll;
   gint scroll_timer;
-  gint scroll_timeout;
+  guint scroll_timeout;
+  gboolean title_overflows;
 
   GtkContainer* container;
   GtkLabel* player_text;
+  // Application icon of the current player, NULL unless player-icon is set
+  GtkImage* player_icon;
+  GdkPixbuf* player_icon_shown;
+  MediaIconCache* icon_cache;
+  // Elapsed or remaining time, NULL unless time-format is set
+  GtkLabel* time_label;
+  gchar time_text[32];
+  gint64 time_length;
+  guint time_timeout;
+
+  // NULL when the title is ellipsized instead of scrolled
   GtkScrolledWindow* title_scroll;
   GtkLabel* title;
+  // Cluster offsets of the current title and the shortened text shown
+  GArray* title_clusters;
+  GString* title_display;
 
   GtkButton* btn_prev;
   GtkButton* btn_next;
   GtkButton* btn_play;
 
+  // Click on the progress line and horizontal scroll over the title
+  GtkGesture* progress_gesture;
+  GtkEventController* title_scroll_controller;
+  // Vertical scroll over the module, the label is only shown while in use
+  GtkEventController* volume_controller;
+  GtkLabel* volume_label;
+  guint volume_timeout;
+
+  // Queue of the current player, the list only lives while it is shown
+  GtkPopover* track_popover;
+  GtkTreeView* track_view;
+  GtkListStore* track_store;
+  MprisTrackList* track_list;
+
   GtkWindow* tooltip_window;
   GtkImage* tooltip_image;
+  gchar* tooltip_art_url;
 
   GMprisMediaManager* media_manager;
   GMprisMediaPlayer* current_player;
   GList* media_players;
 
   GtkMediaControllerState state;
+
+  MediaViewModel view;
+  // Field styles of the title, NULL when unstyled
+  MediaTitleStyle* title_style;
+  // GMprisMediaPlayerField mask of the metadata the widget shows
+  guint player_fields;
+
+  MediaSnapshot* snapshot;
+  gboolean snapshot_active;
+  // Player the stored record was built from, only compared
+  gpointer snapshot_player;
+  guint start_source;
+
+  gboolean manager_ready;
 };
 
 struct _GtkMediaControllerClass
@@ -152,15 +212,105 @@ gtk_media_controller_set_property(GObject * object, guint prop_id, const GValue
   }
 }
 
+/*
+ * Runs when the module is unloaded (gtk_widget_destroy in wbcffi_deinit).
+ * Everything that can call back into the controller is cut here, players
+ * may outlive it for as long as their in flight calls hold them.
+ */
+static void
+gtk_media_controller_dispose(GObject * object)
+{
+  g_debug("gtk_media_controller_dispose entered");
+  GtkMediaController *self = GTK_MEDIA_CONTROLLER(object);
+
+  self->state = GTK_MEDIA_CONTROLLER_STATE_STOPPED;
+
+  if(self->scroll_timeout){
+    g_source_remove(self->scroll_timeout);
+    self->scroll_timeout = 0;
+  }
+
+  if(self->start_source){
+    g_source_remove(self->start_source);
+    self->start_source = 0;
+  }
+
+  if(self->time_timeout){
+    g_source_remove(self->time_timeout);
+    self->time_timeout = 0;
+  }
+
+  if(self->volume_timeout){
+    g_source_remove(self->volume_timeout);
+    self->volume_timeout = 0;
+  }
+
+  // Stops the icon theme from calling back
+  g_clear_pointer(&self->icon_cache, media_icon_cache_free);
+  self->player_icon_shown = NULL;
+
+  if(self->media_manager){
+    g_signal_handlers_disconnect_by_data(self->media_manager, self);
+    g_clear_object(&self->media_manager);
+  }
+
+  for(GList* l = self->media_players; l; l = l->next){
+    g_signal_handlers_disconnect_by_data(l->data, self);
+  }
+  g_list_free_full(self->media_players, g_object_unref);
+  self->media_players = NULL;
+  self->current_player = NULL;
+
+  g_clear_object(&self->progress_gesture);
+  g_clear_object(&self->title_scroll_controller);
+  g_clear_object(&self->volume_controller);
+
+  g_clear_pointer(&self->track_list, mpris_track_list_free);
+  if(self->track_popover){
+    g_signal_handlers_disconnect_by_data(self->track_popover, self);
+    gtk_widget_destroy(GTK_WIDGET(self->track_popover));
+    self->track_popover = NULL;
+    self->track_view = NULL;
+  }
+  g_clear_object(&self->track_store);
+
+  if(self->tooltip_window){
+    gtk_widget_destroy(GTK_WIDGET(self->tooltip_window));
+    self->tooltip_window = NULL;
+    self->tooltip_image = NULL;
+  }
+
+  G_OBJECT_CLASS
+      (gtk_media_controller_parent_class)->dispose(object);
+
+  g_debug("gtk_media_controller_dispose exited");
+}
+
 static void
 gtk_media_controller_finalize(GObject * object)
 {
   g_debug("gtk_media_controller_finalize entered");
   GtkMediaController *self = GTK_MEDIA_CONTROLLER(object);
 
-  self->state = GTK_MEDIA_CONTROLLER_STATE_STOPPED;
+  if(self->snapshot){
+    media_snapshot_close(self->snapshot);
+    self->snapshot = NULL;
+  }
+
+  media_view_model_clear(&self->view);
 
-  g_source_remove(self->scroll_timeout);
+  g_clear_pointer(&self->title_style, media_title_style_free);
+
+  if(self->title_clusters){
+    g_array_unref(self->title_clusters);
+    self->title_clusters = NULL;
+  }
+  if(self->title_display){
+    g_string_free(self->title_display, TRUE);
+    self->title_display = NULL;
+  }
+
+  g_clear_pointer(&self->tooltip_art_url, g_free);
 
   if (self->config){
     g_free(self->config->btn_play);
@@ -168,34 +318,404 @@ gtk_media_controller_finalize(GObject * object)
     g_free(self->config->btn_next);
     g_free(self->config->btn_prev);
     g_free(self->config->ignored_players);
+    g_free(self->config->title_format);
+    media_title_format_free(self->config->title_template);
+    for(guint i = 0; i < MEDIA_TITLE_FIELD_LAST; i++) g_free(self->config->title_styles[i]);
     g_free(self->config);
+    self->config = NULL;
+  }
+
+  g_clear_object(&self->container);
+
+  G_OBJECT_CLASS
+      (gtk_media_controller_parent_class)->finalize(object);
+
+  g_debug("gtk_media_controller_finalized exited");
+}
+
+static void
+gtk_media_controller_set_visible(GtkMediaController* self, gboolean visible){
+  if(!visible){
+    if(gtk_widget_get_parent_window(GTK_WIDGET(self->container)) != NULL){
+      MEDIA_STATS_INC(MEDIA_STAT_GTK_MUTATIONS);
+      gtk_container_remove(GTK_CONTAINER(self), GTK_WIDGET(self->container));
+    }
+  } else {
+    if(gtk_widget_get_parent_window(GTK_WIDGET(self->container)) == NULL){
+      MEDIA_STATS_INC(MEDIA_STAT_GTK_MUTATIONS);
+      gtk_container_add(GTK_CONTAINER(self), GTK_WIDGET(self->container));
+      gtk_widget_show_all(GTK_WIDGET(self->container));
+    }
   }
+}
+
+/*
+ * The label keeps its attributes when the text changes, they are only set
+ * again when a span moved.
+ */
+static void
+gtk_media_controller_update_title_attrs(GtkMediaController* self, const MediaTitleSpan* spans){
+  MEDIA_TRACE_SCOPE("title-attrs", NULL);
+
+  gboolean changed;
+  PangoAttrList* attrs = media_title_style_get_attrs(self->title_style, spans, &changed);
+  if(!changed) return;
 
-  if (self->media_players) {
-    g_list_free_full(self->media_players, g_object_unref);
-    self->media_players = NULL;
+  MEDIA_STATS_INC(MEDIA_STAT_GTK_MUTATIONS);
+  gtk_label_set_attributes(self->title, attrs);
+}
+
+#define TITLE_ELLIPSIS "\u2026"
+
+typedef struct _TitleCluster
+{
+  guint index;
+  gint x;
+} TitleCluster;
+
+// Where a byte offset of the full title ends up in the shortened one
+static gsize
+gtk_media_controller_map_offset(gsize offset, gsize head, gsize tail){
+  if(offset <= head) return offset;
+  if(offset < tail) return head;
+  return offset - tail + head + strlen(TITLE_ELLIPSIS);
+}
+
+/*
+ * Shortens the title to title-max-width around an ellipsis. The title is
+ * measured once per text, with its styles, into an array of cluster
+ * offsets; the cut points are then picked from that array.
+ */
+static void
+gtk_media_controller_ellipsize_title(GtkMediaController* self){
+  MEDIA_TRACE_SCOPE("title-ellipsize", NULL);
+
+  const GString* text = self->view.title;
+  MediaTitleSpan spans[MEDIA_TITLE_FIELD_LAST];
+
+  PangoLayout* layout = gtk_widget_create_pango_layout(GTK_WIDGET(self->title), text->str);
+  PangoAttrList* attrs = self->title_style ? media_title_style_build(self->title_style, self->view.spans) : NULL;
+  if(attrs) pango_layout_set_attributes(layout, attrs);
+
+  g_array_set_size(self->title_clusters, 0);
+
+  PangoLayoutIter* iter = pango_layout_get_iter(layout);
+  do {
+    PangoRectangle logical;
+    pango_layout_iter_get_cluster_extents(iter, NULL, &logical);
+    TitleCluster cluster = { pango_layout_iter_get_index(iter), logical.x };
+    g_array_append_val(self->title_clusters, cluster);
+  } while(pango_layout_iter_next_cluster(iter));
+  pango_layout_iter_free(iter);
+
+  gint total;
+  pango_layout_get_size(layout, &total, NULL);
+
+  pango_layout_set_attributes(layout, NULL);
+  pango_layout_set_text(layout, TITLE_ELLIPSIS, -1);
+  gint ellipsis;
+  pango_layout_get_size(layout, &ellipsis, NULL);
+
+  g_object_unref(layout);
+  if(attrs) pango_attr_list_unref(attrs);
+
+  gint max = self->config->title_max_width * PANGO_SCALE;
+  gsize head = text->len, tail = text->len;
+
+  if(total > max){
+    gint budget = MAX(max - ellipsis, 0);
+    gint head_budget = self->config->title_ellipsize == TITLE_ELLIPSIZE_MIDDLE ? budget / 2 : budget;
+    guint n = self->title_clusters->len;
+
+    // The head keeps the whole clusters that fit in its share of the width
+    guint j = 0;
+    while(j + 1 < n && g_array_index(self->title_clusters, TitleCluster, j + 1).x <= head_budget) j++;
+    head = g_array_index(self->title_clusters, TitleCluster, j).index;
+    gint head_width = g_array_index(self->title_clusters, TitleCluster, j).x;
+
+    if(self->config->title_ellipsize == TITLE_ELLIPSIZE_MIDDLE){
+      // The tail takes what the head left, from the last cluster backwards
+      guint t = n;
+      while(t - 1 > j && total - g_array_index(self->title_clusters, TitleCluster, t - 1).x <= budget - head_width) t--;
+      tail = t < n ? g_array_index(self->title_clusters, TitleCluster, t).index : text->len;
+    }
   }
 
-  if(self->media_manager){
-    g_object_unref(self->media_manager);
-    self->media_manager = NULL;
+  if(head == text->len){
+    g_string_assign(self->title_display, text->str);
+    memcpy(spans, self->view.spans, sizeof(spans));
+  } else {
+    g_string_truncate(self->title_display, 0);
+    g_string_append_len(self->title_display, text->str, head);
+    g_string_append(self->title_display, TITLE_ELLIPSIS);
+    g_string_append_len(self->title_display, text->str + tail, text->len - tail);
+
+    for(guint i = 0; i < MEDIA_TITLE_FIELD_LAST; i++){
+      spans[i].start = gtk_media_controller_map_offset(self->view.spans[i].start, head, tail);
+      spans[i].end = gtk_media_controller_map_offset(self->view.spans[i].end, head, tail);
+    }
   }
 
-  g_object_unref(self->container);
-  self->container = NULL;
+  gtk_label_set_text(self->title, self->title_display->str);
+  if(self->title_style) gtk_media_controller_update_title_attrs(self, spans);
+}
 
-  G_OBJECT_CLASS
-      (gtk_media_controller_parent_class)->finalize(object);
+/*
+ * Pushes the view model to the widgets, only the parts flagged in changes
+ * are touched.
+ */
+static void
+gtk_media_controller_apply_view(GtkMediaController* self, guint changes){
+  if(changes & MEDIA_VIEW_CHANGED_VISIBLE){
+    gtk_media_controller_set_visible(self, self->view.visible);
+    // Showing the container shows every child, bring them all in line
+    if(self->view.visible) changes = MEDIA_VIEW_CHANGED_ALL;
+  }
 
-  g_debug("gtk_media_controller_finalized exited");
+  if(!self->view.visible) return;
+
+  if(self->player_text != NULL && (changes & MEDIA_VIEW_CHANGED_COUNTER)){
+    MEDIA_STATS_INC(MEDIA_STAT_GTK_MUTATIONS);
+    gtk_label_set_text(GTK_LABEL(self->player_text), self->view.counter);
+  }
+
+  if(!self->title) return;
+
+  if(changes & MEDIA_VIEW_CHANGED_TITLE){
+    MEDIA_STATS_INC(MEDIA_STAT_GTK_MUTATIONS);
+
+    if(!self->title_scroll){
+      // Shortened to fit, there is never anything to scroll
+      gtk_media_controller_ellipsize_title(self);
+      self->title_overflows = FALSE;
+    } else {
+      gtk_label_set_text(self->title, self->view.title->str);
+      if(self->title_style) gtk_media_controller_update_title_attrs(self, self->view.spans);
+
+      PangoLayout* layout = gtk_label_get_layout(GTK_LABEL(self->title));
+      gint min_width, min_height; 
+      pango_layout_get_pixel_size(layout, &min_width, &min_height);
+      self->title_overflows = min_width > self->config->title_max_width;
+      if(self->title_overflows) min_width = self->config->title_max_width;
+      gtk_widget_set_size_request(GTK_WIDGET(self->title_scroll), min_width, 0);
+    }
+  }
+
+  if(changes & MEDIA_VIEW_CHANGED_PLAYING){
+    MEDIA_STATS_INC(MEDIA_STAT_GTK_MUTATIONS);
+    gtk_button_set_label(self->btn_play, self->view.playing ? self->config->btn_pause : self->config->btn_play);
+  }
+
+  if(changes & MEDIA_VIEW_CHANGED_PREVIOUS){
+    MEDIA_STATS_INC(MEDIA_STAT_GTK_MUTATIONS);
+    g_debug("can-go-previous => %s", (self->view.show_previous ? "TRUE" : "FALSE"));
+    gtk_widget_set_visible(GTK_WIDGET(self->btn_prev), self->view.show_previous);
+  }
+
+  if(changes & MEDIA_VIEW_CHANGED_NEXT){
+    MEDIA_STATS_INC(MEDIA_STAT_GTK_MUTATIONS);
+    g_debug("can-go-next => %s", (self->view.show_next ? "TRUE" : "FALSE"));
+    gtk_widget_set_visible(GTK_WIDGET(self->btn_next), self->view.show_next);
+  }
+
+  if(changes & MEDIA_VIEW_CHANGED_PROGRESS){
+    gtk_widget_queue_draw(GTK_WIDGET(self->container));
+  }
+}
+
+static void gtk_media_controller_reset_title_scroll(GtkMediaController* self, gboolean reversed);
+static gboolean gtk_media_controller_title_scroll(gpointer user_data);
+
+/*
+ * The scroll timer only exists while a playing title does not fit, an idle
+ * or paused bar must not wake up the main loop.
+ */
+static void
+gtk_media_controller_sync_scroll_timer(GtkMediaController* self){
+  gboolean scroll = self->config->scroll_title && self->title && self->title_scroll &&
+                    self->view.visible && self->view.playing && self->title_overflows;
+
+  if(scroll && !self->scroll_timeout){
+    gtk_media_controller_reset_title_scroll(self, FALSE);
+    self->scroll_timeout = g_timeout_add(self->config->scroll_interval, gtk_media_controller_title_scroll, self);
+  } else if(!scroll && self->scroll_timeout){
+    g_source_remove(self->scroll_timeout);
+    self->scroll_timeout = 0;
+    gtk_media_controller_reset_title_scroll(self, FALSE);
+  }
+}
+
+static void
+gtk_media_controller_render_snapshot(GtkMediaController* self, const MediaSnapshotData* data){
+  g_debug("gtk_media_controller_render_snapshot entered");
+
+  MediaViewInput input = {0};
+
+  if(data != NULL){
+    input.player_pos = data->player_pos;
+    input.player_count = data->player_count;
+    input.fields[MEDIA_TITLE_FIELD_ARTIST] = data->artist;
+    input.fields[MEDIA_TITLE_FIELD_TITLE] = data->title;
+    input.fields[MEDIA_TITLE_FIELD_PLAYER] = data->identity;
+    input.playing = data->state == G_MPRIS_MEDIA_PLAYER_STATE_PLAYING;
+    input.can_go_previous = (data->caps & MEDIA_SNAPSHOT_CAN_GO_PREVIOUS) != 0;
+    input.can_go_next = (data->caps & MEDIA_SNAPSHOT_CAN_GO_NEXT) != 0;
+  }
+
+  gtk_media_controller_apply_view(self, media_view_model_update(&self->view, &input));
+  gtk_media_controller_sync_scroll_timer(self);
+
+  g_debug("gtk_media_controller_render_snapshot exited");
 }
 
+/*
+ * The record holds what the snapshot renders, so it is only rebuilt when
+ * the view changed in one of those parts or another player is shown.
+ */
+#define MEDIA_SNAPSHOT_VIEW_CHANGES (MEDIA_VIEW_CHANGED_VISIBLE | MEDIA_VIEW_CHANGED_COUNTER | \
+                                     MEDIA_VIEW_CHANGED_TITLE | MEDIA_VIEW_CHANGED_PLAYING | \
+                                     MEDIA_VIEW_CHANGED_PREVIOUS | MEDIA_VIEW_CHANGED_NEXT)
+
+static void
+gtk_media_controller_store_snapshot(GtkMediaController* self, guint changes, guint pos, guint size){
+  if(!self->snapshot) return;
+
+  gpointer player = size > 0 ? self->current_player : NULL;
+  if(!(changes & MEDIA_SNAPSHOT_VIEW_CHANGES) && player == self->snapshot_player) return;
+  self->snapshot_player = player;
+
+  MediaSnapshotData data;
+  memset(&data, 0, sizeof(data));
+  data.magic = MEDIA_SNAPSHOT_MAGIC;
+  data.version = MEDIA_SNAPSHOT_VERSION;
+
+  if(player){
+    GMprisMediaPlayerState state;
+    gboolean can_go_next, can_go_previous, can_play, can_control;
+
+    g_object_get(G_OBJECT(self->current_player),
+                  "state", &state,
+                  "can-go-next", &can_go_next,
+                  "can-go-previous", &can_go_previous,
+                  "can-play", &can_play,
+                  "can-control", &can_control,
+                  NULL);
+
+    data.state = state;
+    data.caps = (can_go_next ? MEDIA_SNAPSHOT_CAN_GO_NEXT : 0) |
+                (can_go_previous ? MEDIA_SNAPSHOT_CAN_GO_PREVIOUS : 0) |
+                (can_play ? MEDIA_SNAPSHOT_CAN_PLAY : 0) |
+                (can_control ? MEDIA_SNAPSHOT_CAN_CONTROL : 0);
+    data.player_pos = pos;
+    data.player_count = size;
+
+    const gchar* arturl = g_mpris_media_player_get_art_url(self->current_player);
+    data.art_key = arturl[0] ? g_str_hash(arturl) : 0;
+
+    const gchar* identity = g_mpris_media_player_get_identity(self->current_player);
+    if(!identity[0]) identity = g_mpris_media_player_get_bus_name(self->current_player);
+    if(g_str_has_prefix(identity, MPRIS_PREFIX)) identity += strlen(MPRIS_PREFIX);
+
+    media_snapshot_set_string(data.identity, sizeof(data.identity), identity);
+    media_snapshot_set_string(data.artist, sizeof(data.artist), g_mpris_media_player_get_artist(self->current_player));
+    media_snapshot_set_string(data.title, sizeof(data.title), g_mpris_media_player_get_title(self->current_player));
+  }
+
+  media_snapshot_store(self->snapshot, &data);
+}
+
+/*
+ * Reads only the fields the title template shows from the current player.
+ * The strings are borrowed from the player, only the track number is
+ * formatted into track.
+ */
+static void
+gtk_media_controller_get_title_fields(GtkMediaController* self, MediaViewInput* input,
+                                      gchar* track, gsize track_size){
+  GMprisMediaPlayer* player = self->current_player;
+  guint used = media_title_format_get_fields(self->view.format);
+
+  if(used & MEDIA_TITLE_FIELD_MASK(MEDIA_TITLE_FIELD_ARTIST))
+    input->fields[MEDIA_TITLE_FIELD_ARTIST] = g_mpris_media_player_get_artist(player);
+  if(used & MEDIA_TITLE_FIELD_MASK(MEDIA_TITLE_FIELD_TITLE))
+    input->fields[MEDIA_TITLE_FIELD_TITLE] = g_mpris_media_player_get_title(player);
+  if(used & MEDIA_TITLE_FIELD_MASK(MEDIA_TITLE_FIELD_ALBUM))
+    input->fields[MEDIA_TITLE_FIELD_ALBUM] = g_mpris_media_player_get_album(player);
+
+  if(used & MEDIA_TITLE_FIELD_MASK(MEDIA_TITLE_FIELD_TRACK)){
+    gint track_number = g_mpris_media_player_get_track_number(player);
+
+    track[0] = '\0';
+    if(track_number > 0) g_snprintf(track, track_size, "%d", track_number);
+    input->fields[MEDIA_TITLE_FIELD_TRACK] = track;
+  }
+
+  if(used & MEDIA_TITLE_FIELD_MASK(MEDIA_TITLE_FIELD_PLAYER)){
+    const gchar* identity = g_mpris_media_player_get_identity(player);
+
+    if(!identity[0]){
+      identity = g_mpris_media_player_get_bus_name(player);
+      if(identity && g_str_has_prefix(identity, MPRIS_PREFIX)) identity += strlen(MPRIS_PREFIX);
+    }
+    input->fields[MEDIA_TITLE_FIELD_PLAYER] = identity;
+  }
+}
+
+/*
+ * Shows the icon of the current player. Lookups go through the cache, the
+ * image is only touched when the icon differs.
+ */
+static void
+gtk_media_controller_update_player_icon(GtkMediaController* self){
+  if(!self->player_icon || !self->icon_cache) return;
+
+  GdkPixbuf* pixbuf = NULL;
+
+  if(self->current_player && self->view.visible){
+    gchar* desktop_entry = NULL;
+    gchar* identity = NULL;
+
+    g_object_get(G_OBJECT(self->current_player),
+                  "desktop-entry", &desktop_entry,
+                  "identity", &identity,
+                  NULL);
+
+    pixbuf = media_icon_cache_lookup(self->icon_cache, desktop_entry, identity);
+
+    g_free(desktop_entry);
+    g_free(identity);
+  }
+
+  if(pixbuf == self->player_icon_shown) return;
+  self->player_icon_shown = pixbuf;
+
+  MEDIA_STATS_INC(MEDIA_STAT_GTK_MUTATIONS);
+  gtk_image_set_from_pixbuf(self->player_icon, pixbuf);
+  gtk_widget_set_visible(GTK_WIDGET(self->player_icon), pixbuf != NULL);
+}
+
+static void
+gtk_media_controller_on_icons_changed(gpointer user_data){
+  GtkMediaController* self = GTK_MEDIA_CONTROLLER(user_data);
+
+  // The shown pixbuf was dropped with the cache
+  self->player_icon_shown = NULL;
+  gtk_image_clear(self->player_icon);
+  gtk_media_controller_update_player_icon(self);
+}
+
+static void gtk_media_controller_update_time(GtkMediaController* self);
+
 static void 
 gtk_media_controller_update(GtkMediaController* self) {
   g_debug("gtk_media_controller_update entered");
 
   if(!self->container) return;
 
+  MEDIA_STATS_INC(MEDIA_STAT_CONTROLLER_UPDATES);
+  media_timeline_mark(MEDIA_TIMELINE_FIRST_UPDATE);
+  MEDIA_TRACE_SCOPE("controller-update", NULL);
+
   guint pos = 0;
   guint size = 0;
   for(struct {int idx; GList* item; } loop = {0, g_list_first(self->media_players)}; loop.item; loop.item = loop.item->next){
@@ -213,108 +733,163 @@ gtk_media_controller_update(GtkMediaController* self) {
   }
 
   if(self->media_players == NULL || size == 0){
-    if(gtk_widget_get_parent_window(GTK_WIDGET(self->container)) != NULL){
-      gtk_container_remove(GTK_CONTAINER(self), GTK_WIDGET(self->container));
-    }
-    return;
-  } else {
-    if(gtk_widget_get_parent_window(GTK_WIDGET(self->container)) == NULL){
-      gtk_container_add(GTK_CONTAINER(self), GTK_WIDGET(self->container));
-      gtk_widget_show_all(GTK_WIDGET(self->container));
+    if(self->snapshot_active){
+      // Live players are still being collected, keep the last known state
+      MediaSnapshotData data;
+      gtk_media_controller_render_snapshot(self, media_snapshot_peek(self->snapshot, &data) ? &data : NULL);
+      return;
     }
+    size = 0;
+  }
+
+  MediaViewInput input = {0};
+  gchar track[16];
+
+  input.player_count = size;
+
+  if(size > 0 && self->current_player){
+    GMprisMediaPlayerState state;
+
+    gtk_media_controller_get_title_fields(self, &input, track, sizeof(track));
+
+    g_object_get(G_OBJECT(self->current_player), 
+                  "state", &state,
+                  "can-go-previous", &input.can_go_previous,
+                  "can-go-next", &input.can_go_next,
+                  "position", &input.position,
+                  "length", &input.length,
+                  NULL); 
+
+    input.player_pos = pos;
+    input.playing = state == G_MPRIS_MEDIA_PLAYER_STATE_PLAYING;
+    input.has_progress = state == G_MPRIS_MEDIA_PLAYER_STATE_PLAYING ||
+                         state == G_MPRIS_MEDIA_PLAYER_STATE_PAUSED;
+  }
+
+  guint changes = media_view_model_update(&self->view, &input);
+  gtk_media_controller_apply_view(self, changes);
+  gtk_media_controller_sync_scroll_timer(self);
+  gtk_media_controller_update_time(self);
+  gtk_media_controller_update_player_icon(self);
+
+  gtk_media_controller_store_snapshot(self, changes, pos, size);
+
+  g_debug("gtk_media_controller_update exited");
 }
 
-  if(self->player_text != NULL){
-    if(self->current_player !=NULL){
-      gint mem_size = (ceil(log10(pos || 1))+1+ceil(log10(size || 1))+1+4) * sizeof(gchar);
-      gchar* text = g_malloc(mem_size);
-      g_snprintf(text, mem_size, "[%d/%d]", pos, size);
-      gtk_label_set_text(GTK_LABEL(self->player_text),text);
-      g_free(text);
-    }
+// m:ss, or h:mm:ss from an hour on
+static gint
+gtk_media_controller_format_time(gchar* out, gsize size, gint64 usec){
+  gint64 secs = MAX(usec, 0) / G_USEC_PER_SEC;
+
+  if(secs >= 3600)
+    return g_snprintf(out, size, "%d:%02d:%02d", (gint)(secs / 3600), (gint)(secs / 60 % 60), (gint)(secs % 60));
+
+  return g_snprintf(out, size, "%d:%02d", (gint)(secs / 60), (gint)(secs % 60));
+}
+
+static void
+gtk_media_controller_format_time_text(GtkMediaController* self, gchar* out, gsize size,
+                                      gint64 position, gint64 length){
+  out[0] = '\0';
+
+  if(length <= 0){
+    gtk_media_controller_format_time(out, size, position);
+  } else if(self->config->time_format == TIME_FORMAT_REMAINING){
+    out[0] = '-';
+    gtk_media_controller_format_time(out + 1, size - 1, length - position);
+  } else {
+    gint len = gtk_media_controller_format_time(out, size, position);
+    g_strlcpy(out + len, " / ", size - len);
+    gtk_media_controller_format_time(out + len + 3, size - len - 3, length);
   }
- 
-  if(self->title){
-    if(self->current_player){
-      gchar* artist = NULL;
-      gchar* title = NULL;
-      g_object_get(G_OBJECT(self->current_player), 
-                    "artist", &artist,
-                    "title", &title,
-                    NULL); 
-
-      artist = g_strstrip(artist);
-      title = g_strstrip(title);
-
-      if((artist && strlen(artist) > 0) || (title && strlen(title) > 0)){
-        gint mem_size = 0;
-        if(artist && strlen(artist) > 0) mem_size += strlen(artist);
-        if(title && strlen(title) > 0) mem_size += strlen(title);
-
-        gint final_size = mem_size+4;
-        gchar* final_title = g_malloc(final_size);
-        if(artist && strlen(artist) > 0 && title && strlen(title) > 0){
-          g_snprintf(final_title,final_size, "%s - %s", artist, title);
-        } else if(artist && strlen(artist) > 0) {
-          g_snprintf(final_title,final_size, "%s", artist);
-        } else if(title && strlen(title) > 0) {
-          g_snprintf(final_title,final_size, "%s", title);
-        }        
-
-        if(mem_size > 0)
-          gtk_label_set_text(self->title, final_title);
-        else
-          gtk_label_set_text(self->title, "No Name");
-
-        g_free(final_title);
-      } else {
-        gtk_label_set_text(self->title, "No Media");
-      }
+}
 
-      PangoLayout* layout = gtk_label_get_layout(GTK_LABEL(self->title));
-      gint min_width, min_height; 
-      pango_layout_get_pixel_size(layout, &min_width, &min_height);
-      if(min_width > self->config->title_max_width) min_width = self->config->title_max_width;
-      gtk_widget_set_size_request(GTK_WIDGET(self->title_scroll), min_width, 0);
+/*
+ * Digits are tabular, so the widest text for a track is the one built from
+ * its length. The label is sized to it once per track and never resizes
+ * while the time runs.
+ */
+static void
+gtk_media_controller_size_time_label(GtkMediaController* self, gint64 length){
+  if(length == self->time_length) return;
+  self->time_length = length;
 
-      if(artist)
-        g_free(artist);
-      if(title)
-        g_free(title);
-    }
+  gchar widest[sizeof(self->time_text)];
+  gtk_media_controller_format_time_text(self, widest, sizeof(widest), length, length);
 
-    if(self->media_players && self->current_player){
-      GList* item = g_list_find_custom(g_list_first(self->media_players), self->current_player, g_mpris_media_player_compare);
-      if(item){
-        GMprisMediaPlayer* player = (GMprisMediaPlayer*)item->data;
+  PangoLayout* layout = gtk_widget_create_pango_layout(GTK_WIDGET(self->time_label), widest);
+  pango_layout_set_attributes(layout, gtk_label_get_attributes(self->time_label));
 
-        GMprisMediaPlayerState state;
-        g_object_get(G_OBJECT(player), "state", &state, NULL); 
+  gint width;
+  pango_layout_get_pixel_size(layout, &width, NULL);
+  g_object_unref(layout);
 
-        if(state == G_MPRIS_MEDIA_PLAYER_STATE_PLAYING){
-          gtk_button_set_label(self->btn_play, self->config->btn_pause);
-        } else {
-          gtk_button_set_label(self->btn_play, self->config->btn_play);
-        }
+  MEDIA_STATS_INC(MEDIA_STAT_GTK_MUTATIONS);
+  gtk_widget_set_size_request(GTK_WIDGET(self->time_label), width, -1);
+}
 
-        gboolean val = FALSE;
-        g_object_get(G_OBJECT(player), "can-go-previous", &val, NULL);
-        g_debug("can-go-previous => %s", (val ? "TRUE" : "FALSE"));
-        if(!val)
-          gtk_widget_hide(GTK_WIDGET(self->btn_prev));
-        else
-          gtk_widget_show(GTK_WIDGET(self->btn_prev));
-
-        g_object_get(G_OBJECT(player), "can-go-next", &val, NULL);
-        g_debug("can-go-next => %s", (val ? "TRUE" : "FALSE"));
-        if(!val)
-          gtk_widget_hide(GTK_WIDGET(self->btn_next));
-        else
-          gtk_widget_show(GTK_WIDGET(self->btn_next));
-      }
+static gboolean gtk_media_controller_on_time_timeout(gpointer user_data);
+
+/*
+ * Refreshes the time label and, while playing, arms a one shot timeout for
+ * the moment the shown second changes. The label is only touched when its
+ * text differs.
+ */
+static void
+gtk_media_controller_update_time(GtkMediaController* self){
+  if(!self->time_label) return;
+
+  if(self->time_timeout){
+    g_source_remove(self->time_timeout);
+    self->time_timeout = 0;
+  }
+
+  gchar text[sizeof(self->time_text)] = "";
+  gint64 position = 0, length = 0;
+  gboolean playing = FALSE;
+
+  if(self->current_player && self->view.visible){
+    GMprisMediaPlayerState state;
+    g_object_get(G_OBJECT(self->current_player), "state", &state, "length", &length, NULL);
+
+    if(state == G_MPRIS_MEDIA_PLAYER_STATE_PLAYING || state == G_MPRIS_MEDIA_PLAYER_STATE_PAUSED){
+      position = g_mpris_media_player_get_position_estimate(self->current_player);
+      playing = state == G_MPRIS_MEDIA_PLAYER_STATE_PLAYING;
+
+      gtk_media_controller_size_time_label(self, length);
+      gtk_media_controller_format_time_text(self, text, sizeof(text), position, length);
     }
   }
-  g_debug("gtk_media_controller_update exited");
+
+  if(strcmp(text, self->time_text) != 0){
+    memcpy(self->time_text, text, sizeof(text));
+    MEDIA_STATS_INC(MEDIA_STAT_GTK_MUTATIONS);
+    gtk_label_set_text(self->time_label, self->time_text);
+  }
+
+  if(!playing) return;
+
+  // Remaining time is shown rounded down as well, so it changes when the
+  // time left crosses a second
+  gint64 shown = self->config->time_format == TIME_FORMAT_REMAINING && length > 0 ? length - position : position;
+  gint64 until = self->config->time_format == TIME_FORMAT_REMAINING && length > 0 ?
+                   shown % G_USEC_PER_SEC + 1 : G_USEC_PER_SEC - shown % G_USEC_PER_SEC;
+
+  self->time_timeout = g_timeout_add(until / 1000 + 1, gtk_media_controller_on_time_timeout, self);
+}
+
+static gboolean
+gtk_media_controller_on_time_timeout(gpointer user_data){
+  GtkMediaController* self = GTK_MEDIA_CONTROLLER(user_data);
+  MEDIA_WATCHDOG_SCOPE("gtk_media_controller_on_time_timeout", NULL);
+
+  MEDIA_STATS_INC(MEDIA_STAT_TIMER_WAKEUPS);
+
+  self->time_timeout = 0;
+  gtk_media_controller_update_time(self);
+
+  return G_SOURCE_REMOVE;
 }
 
 static void 
@@ -324,19 +899,24 @@ gtk_media_controller_reset_title_scroll(GtkMediaController* self, gboolean rever
   if(self->config)
     self->scroll_timer = self->config->scroll_before_timeout*(1000/self->config->scroll_interval);
 
-  if(self->container && gtk_widget_get_parent(GTK_WIDGET(self->container)) && !reversed){
+  if(self->title_scroll && self->container && gtk_widget_get_parent(GTK_WIDGET(self->container)) && !reversed){
     GtkAdjustment* adjustment = gtk_scrolled_window_get_hadjustment(GTK_SCROLLED_WINDOW(self->title_scroll));
     if(adjustment != NULL)
       gtk_adjustment_set_value(adjustment, 0);
   }
 }
 
+static void gtk_media_controller_close_track_list(GtkMediaController* self);
+
 static void
 gtk_media_controller_set_player(GtkMediaController* self, GMprisMediaPlayer* player){
   if(self->current_player != NULL && player != NULL && g_mpris_media_player_compare(self->current_player,player) != 0){
     gtk_media_controller_reset_title_scroll(self, FALSE);
   }
 
+  // The queue shown belongs to the previous player
+  if(player != self->current_player) gtk_media_controller_close_track_list(self);
+
   self->current_player = player;
 
   if(player != NULL){
@@ -356,6 +936,7 @@ gtk_media_controller_player_add(GtkMediaController* self, GMprisMediaPlayer* pla
   GList* item = g_list_find_custom(g_list_first(self->media_players), player, g_mpris_media_player_compare);
   if(item == NULL){
     self->media_players = g_list_append(self->media_players, player);
+    g_mpris_media_player_set_fields(player, self->player_fields);
 
     g_info("New player added to media controller");
 
@@ -422,6 +1003,8 @@ gtk_media_controller_player_remove(GtkMediaController* self, GMprisMediaPlayer*
     GList* item = g_list_find_custom(g_list_first(self->media_players), player, g_mpris_media_player_compare);
     if(item != NULL){
       gtk_media_controller_select_next_player(self, player);
+      if(self->current_player == item->data) gtk_media_controller_set_player(self, NULL);
+      g_signal_handlers_disconnect_by_data(item->data, self);
       self->media_players = g_list_remove_link(self->media_players, item);
       g_list_free_full(item, g_object_unref);
     }
@@ -441,6 +1024,13 @@ gtk_media_controller_on_player_property_changed(GMprisMediaPlayer* player, gpoin
   g_debug("gtk_media_controller_on_player_property_changed entered");
 
   GtkMediaController* self = GTK_MEDIA_CONTROLLER(user_data);
+  MEDIA_WATCHDOG_SCOPE("gtk_media_controller_on_player_property_changed", g_mpris_media_player_get_bus_name(player));
+
+  // Players become available once their properties arrive, after they
+  // have been added
+  if(self->current_player == NULL && g_is_mpris_media_player_available(player)){
+    gtk_media_controller_set_player(self, player);
+  }
 
   gtk_media_controller_update(self);
 
@@ -457,6 +1047,7 @@ gtk_media_controller_on_player_state_changed(GMprisMediaPlayer* player, gpointer
   g_debug("gtk_media_controller_on_player_state_changed entered");
 
   GtkMediaController* self = GTK_MEDIA_CONTROLLER(user_data);
+  MEDIA_WATCHDOG_SCOPE("gtk_media_controller_on_player_state_changed", g_mpris_media_player_get_bus_name(player));
 
   GMprisMediaPlayerState state;
   g_object_get(G_OBJECT(player), "state", &state, NULL);
@@ -537,6 +1128,35 @@ static void mpris_on_player_removed(GMprisMediaManager* manager, GMprisMediaPlay
   g_debug("mpris_on_player_removed exited");
 }
 
+static void mpris_on_manager_ready(GMprisMediaManager* manager, gpointer user_data){
+  g_debug("mpris_on_manager_ready entered");
+  GtkMediaController* self = GTK_MEDIA_CONTROLLER(user_data);
+
+  // Live data is authoritative from now on
+  self->snapshot_active = FALSE;
+  self->manager_ready = TRUE;
+  gtk_media_controller_update(self);
+
+  // Without a player nothing gets drawn, the startup ends here
+  if(!self->view.visible) media_timeline_finish();
+
+  g_debug("mpris_on_manager_ready exited");
+}
+
+static gboolean
+gtk_media_controller_start(gpointer user_data){
+  g_debug("gtk_media_controller_start entered");
+  GtkMediaController* self = GTK_MEDIA_CONTROLLER(user_data);
+  MEDIA_WATCHDOG_SCOPE("gtk_media_controller_start", NULL);
+
+  self->start_source = 0;
+
+  g_mpris_media_manager_start(self->media_manager);
+
+  g_debug("gtk_media_controller_start exited");
+  return G_SOURCE_REMOVE;
+}
+
 static void
 gtk_media_controller_constructed(GObject* object)
 {
@@ -549,7 +1169,7 @@ gtk_media_controller_constructed(GObject* object)
 
   g_signal_connect(self->media_manager, "player-removed", G_CALLBACK(mpris_on_player_removed), self);
 
-  g_mpris_media_manager_start(self->media_manager);
+  g_signal_connect(self->media_manager, "ready", G_CALLBACK(mpris_on_manager_ready), self);
 
   g_debug("gtk_media_controller_constructed fnished");
 }
@@ -561,6 +1181,7 @@ gtk_media_controller_class_init(GtkMediaControllerClass * klass)
 
   gobject_class->set_property = gtk_media_controller_set_property;
   gobject_class->get_property = gtk_media_controller_get_property;
+  gobject_class->dispose = gtk_media_controller_dispose;
   gobject_class->finalize = gtk_media_controller_finalize;
   gobject_class->constructed = gtk_media_controller_constructed;
 
@@ -597,22 +1218,173 @@ gtk_media_controller_init(GtkMediaController * self)
   g_info("Initializing player");
   self->media_players = NULL;
   self->current_player = NULL;
+  self->snapshot = NULL;
+  self->snapshot_active = FALSE;
+  self->snapshot_player = NULL;
+  self->start_source = 0;
+  self->manager_ready = FALSE;
+  self->time_length = -1;
+}
+
+/*
+ * Rows are drawn only while visible, so asking for the metadata here is
+ * what pages it in as the list scrolls.
+ */
+static void
+gtk_media_controller_track_cell_data(GtkTreeViewColumn* column, GtkCellRenderer* cell,
+                                     GtkTreeModel* model, GtkTreeIter* iter, gpointer user_data){
+  GtkMediaController* self = GTK_MEDIA_CONTROLLER(user_data);
+  if(!self->track_list) return;
+
+  GtkTreePath* path = gtk_tree_model_get_path(model, iter);
+  guint position = gtk_tree_path_get_indices(path)[0];
+  gtk_tree_path_free(path);
+
+  const gchar *title, *artist;
+  gchar text[256];
+
+  if(!mpris_track_list_get_metadata(self->track_list, position, &title, &artist)){
+    g_object_set(cell, "text", "\u2026", NULL);
+  } else if(artist[0] && title[0]){
+    g_snprintf(text, sizeof(text), "%s - %s", artist, title);
+    g_object_set(cell, "text", text, NULL);
+  } else {
+    g_object_set(cell, "text", title[0] ? title : artist, NULL);
+  }
+}
+
+static void
+gtk_media_controller_on_track_list_changed(gpointer user_data, MprisTrackListChange change,
+                                           guint position, guint count){
+  GtkMediaController* self = GTK_MEDIA_CONTROLLER(user_data);
+  GtkTreeIter iter;
+
+  switch(change){
+    case MPRIS_TRACK_LIST_RESET:
+      // Detached while refilled so the view does not track every row
+      gtk_tree_view_set_model(self->track_view, NULL);
+      gtk_list_store_clear(self->track_store);
+      for(guint i = 0; i < count; i++) gtk_list_store_insert_with_values(self->track_store, NULL, -1, -1);
+      gtk_tree_view_set_model(self->track_view, GTK_TREE_MODEL(self->track_store));
+      break;
+    case MPRIS_TRACK_LIST_INSERTED:
+      gtk_list_store_insert(self->track_store, &iter, position);
+      break;
+    case MPRIS_TRACK_LIST_REMOVED:
+      if(gtk_tree_model_iter_nth_child(GTK_TREE_MODEL(self->track_store), &iter, NULL, position))
+        gtk_list_store_remove(self->track_store, &iter);
+      break;
+    case MPRIS_TRACK_LIST_LOADED:
+      MEDIA_STATS_INC(MEDIA_STAT_REDRAWS);
+      gtk_widget_queue_draw(GTK_WIDGET(self->track_view));
+      break;
+  }
+}
+
+static void
+gtk_media_controller_close_track_list(GtkMediaController* self){
+  if(!self->track_list) return;
+
+  g_clear_pointer(&self->track_list, mpris_track_list_free);
+  gtk_list_store_clear(self->track_store);
+
+  if(gtk_widget_get_visible(GTK_WIDGET(self->track_popover))) gtk_popover_popdown(self->track_popover);
+}
+
+static void
+gtk_media_controller_on_track_popover_closed(GtkPopover* popover, gpointer user_data){
+  gtk_media_controller_close_track_list(GTK_MEDIA_CONTROLLER(user_data));
+}
+
+static void
+gtk_media_controller_on_track_activated(GtkTreeView* view, GtkTreePath* path,
+                                        GtkTreeViewColumn* column, gpointer user_data){
+  GtkMediaController* self = GTK_MEDIA_CONTROLLER(user_data);
+  if(!self->track_list) return;
+
+  mpris_track_list_go_to(self->track_list, gtk_tree_path_get_indices(path)[0]);
+  gtk_media_controller_close_track_list(self);
+}
+
+static void
+gtk_media_controller_create_track_popover(GtkMediaController* self){
+  self->track_store = gtk_list_store_new(1, G_TYPE_BOOLEAN);
+
+  // The label may be wider than its scroll window, point at what is visible
+  GtkWidget* anchor = self->title_scroll ? GTK_WIDGET(self->title_scroll) : GTK_WIDGET(self->title);
+  self->track_popover = GTK_POPOVER(gtk_popover_new(anchor));
+  // The bar is only as tall as its widgets, let the list hang out of it
+  gtk_popover_set_constrain_to(self->track_popover, GTK_POPOVER_CONSTRAIN_NONE);
+  g_signal_connect(self->track_popover, "closed", G_CALLBACK(gtk_media_controller_on_track_popover_closed), self);
+
+  GtkWidget* scroll = gtk_scrolled_window_new(NULL, NULL);
+  gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scroll), GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+  gtk_widget_set_size_request(scroll, 350, 300);
+  gtk_container_add(GTK_CONTAINER(self->track_popover), scroll);
+
+  self->track_view = GTK_TREE_VIEW(gtk_tree_view_new_with_model(GTK_TREE_MODEL(self->track_store)));
+  gtk_tree_view_set_headers_visible(self->track_view, FALSE);
+  g_signal_connect(self->track_view, "row-activated", G_CALLBACK(gtk_media_controller_on_track_activated), self);
+
+  GtkCellRenderer* renderer = gtk_cell_renderer_text_new();
+  g_object_set(renderer, "ellipsize", PANGO_ELLIPSIZE_END, NULL);
+
+  // Fixed height rows let the view size thousands of them without
+  // measuring, only the visible ones are ever rendered
+  GtkTreeViewColumn* column = gtk_tree_view_column_new();
+  gtk_tree_view_column_set_sizing(column, GTK_TREE_VIEW_COLUMN_FIXED);
+  gtk_tree_view_column_pack_start(column, renderer, TRUE);
+  gtk_tree_view_column_set_cell_data_func(column, renderer, gtk_media_controller_track_cell_data, self, NULL);
+  gtk_tree_view_append_column(self->track_view, column);
+  gtk_tree_view_set_fixed_height_mode(self->track_view, TRUE);
+
+  gtk_container_add(GTK_CONTAINER(scroll), GTK_WIDGET(self->track_view));
+  gtk_widget_show_all(scroll);
+}
+
+/*
+ * Opens the queue of the current player, when it has one.
+ */
+static void
+gtk_media_controller_open_track_list(GtkMediaController* self){
+  if(!self->current_player || self->track_list) return;
+
+  GDBusConnection* conn = NULL;
+  gboolean has_track_list = FALSE;
+  g_object_get(G_OBJECT(self->current_player), "connection", &conn, "has-track-list", &has_track_list, NULL);
+
+  // Replayed players have no connection to ask
+  if(conn && has_track_list){
+    if(!self->track_popover) gtk_media_controller_create_track_popover(self);
+
+    self->track_list = mpris_track_list_new(conn, g_mpris_media_player_get_bus_name(self->current_player),
+                                            gtk_media_controller_on_track_list_changed, self);
+    gtk_popover_popup(self->track_popover);
+  }
+
+  if(conn) g_object_unref(conn);
 }
 
 void static 
 gtk_media_controller_on_title_bp(GtkLabel* title, GdkEventButton* event, gpointer user_data){
   GtkMediaController* self = GTK_MEDIA_CONTROLLER(user_data);
+  MEDIA_WATCHDOG_SCOPE("gtk_media_controller_on_title_bp", NULL);
 
   if(event->button == 1){
     if(self->current_player) {
+      gint64 start = g_get_monotonic_time();
       g_mpris_media_player_play_pause(self->current_player);
+      g_debug("Play/pause feedback after %.2f ms", (g_get_monotonic_time() - start) / 1000.0);
     }
+  } else if(event->button == 3){
+    gtk_media_controller_open_track_list(self);
   }
 }
 
 void static 
 gtk_media_controller_on_player_bp(GtkLabel* player, GdkEventButton* event, gpointer user_data){
   GtkMediaController* self = GTK_MEDIA_CONTROLLER(user_data);
+  MEDIA_WATCHDOG_SCOPE("gtk_media_controller_on_player_bp", NULL);
   
   if(!self->media_players) return;
 
@@ -628,6 +1400,7 @@ static void
 gtk_media_controller_on_prev_click(GtkButton* btn, gpointer user_data) {
   g_debug("gtk_media_controller_on_prev_click entered");
   GtkMediaController* self = GTK_MEDIA_CONTROLLER(user_data);
+  MEDIA_WATCHDOG_SCOPE("gtk_media_controller_on_prev_click", NULL);
 
   g_mpris_media_player_previous(self->current_player);
 
@@ -639,7 +1412,12 @@ static void
 gtk_media_controller_on_play_click(GtkButton* btn, gpointer user_data) {
   g_debug("gtk_media_controller_on_play_click entered");
   GtkMediaController* self = GTK_MEDIA_CONTROLLER(user_data);
+  MEDIA_WATCHDOG_SCOPE("gtk_media_controller_on_play_click", NULL);
+
+  gint64 start = g_get_monotonic_time();
   g_mpris_media_player_play_pause(self->current_player);
+  g_debug("Play/pause feedback after %.2f ms", (g_get_monotonic_time() - start) / 1000.0);
+
   g_debug("gtk_media_controller_on_play_click exited");
  }
 
@@ -647,6 +1425,7 @@ static void
 gtk_media_controller_on_next_click(GtkButton* btn, gpointer user_data) {
   g_debug("gtk_media_controller_on_next_click entered");
   GtkMediaController* self = GTK_MEDIA_CONTROLLER(user_data);
+  MEDIA_WATCHDOG_SCOPE("gtk_media_controller_on_next_click", NULL);
   g_mpris_media_player_next(self->current_player);
   gtk_media_controller_reset_title_scroll(self, FALSE);
   g_debug("gtk_media_controller_on_next_click exited");
@@ -655,6 +1434,17 @@ gtk_media_controller_on_next_click(GtkButton* btn, gpointer user_data) {
 static gboolean 
 gtk_media_controller_on_draw_progress(GtkWidget* widget, cairo_t* cr, gpointer user_data){
   GtkMediaController* self = GTK_MEDIA_CONTROLLER(user_data);
+  MEDIA_WATCHDOG_SCOPE("gtk_media_controller_on_draw_progress", NULL);
+
+  MEDIA_STATS_INC(MEDIA_STAT_REDRAWS);
+  MEDIA_TRACE_SCOPE("draw-progress", NULL);
+
+  media_timeline_set_first_draw_source(self->snapshot_active ? "snapshot" : "live");
+  media_timeline_mark(MEDIA_TIMELINE_FIRST_DRAW);
+  if(self->manager_ready){
+    media_timeline_mark(MEDIA_TIMELINE_LIVE_DRAW);
+    media_timeline_finish();
+  }
 
   if(self->current_player && self->media_players){
     GtkStyleContext* context = gtk_widget_get_style_context(widget);
@@ -676,9 +1466,9 @@ gtk_media_controller_on_draw_progress(GtkWidget* widget, cairo_t* cr, gpointer u
         gint64 length = 0;
         g_object_get(G_OBJECT(player),"position", &pos, "length", &length, NULL);
 
-        if(length > 0){
-          guint64 por = (pos*100)/length;
-          guint64 bar_width = (width*por)/100;
+        gdouble progress = media_view_progress_fraction(TRUE, pos, length);
+        if(progress > 0){
+          gdouble bar_width = width*progress;
 
           GdkRGBA color;
           gtk_style_context_get_color(context, GTK_STATE_FLAG_NORMAL, &color);
@@ -695,9 +1485,106 @@ gtk_media_controller_on_draw_progress(GtkWidget* widget, cairo_t* cr, gpointer u
   return FALSE;
 }
 
+/*
+ * Seeks are only possible on the player whose progress is drawn.
+ */
+static gboolean
+gtk_media_controller_get_seek_range(GtkMediaController* self, gint64* length){
+  if(!self->current_player || !self->media_players) return FALSE;
+
+  GMprisMediaPlayerState state;
+  g_object_get(G_OBJECT(self->current_player), "state", &state, "length", length, NULL);
+
+  return (state == G_MPRIS_MEDIA_PLAYER_STATE_PLAYING ||
+          state == G_MPRIS_MEDIA_PLAYER_STATE_PAUSED) && *length > 0;
+}
+
+static void
+gtk_media_controller_on_progress_pressed(GtkGestureMultiPress* gesture, gint n_press,
+                                         gdouble x, gdouble y, gpointer user_data){
+  GtkMediaController* self = GTK_MEDIA_CONTROLLER(user_data);
+  MEDIA_WATCHDOG_SCOPE("gtk_media_controller_on_progress_pressed", NULL);
+  GtkWidget* widget = GTK_WIDGET(self->container);
+
+  gint64 length = 0;
+  gint width = gtk_widget_get_allocated_width(widget);
+
+  if(y < gtk_widget_get_allocated_height(widget) - PROGRESS_HIT_HEIGHT || width <= 0 ||
+     !gtk_media_controller_get_seek_range(self, &length)){
+    gtk_gesture_set_state(GTK_GESTURE(gesture), GTK_EVENT_SEQUENCE_DENIED);
+    return;
+  }
+
+  // Claimed so the button under the line does not see the click
+  gtk_gesture_set_state(GTK_GESTURE(gesture), GTK_EVENT_SEQUENCE_CLAIMED);
+
+  g_mpris_media_player_set_position(self->current_player, length * CLAMP(x / width, 0.0, 1.0));
+  gtk_widget_queue_draw(widget);
+}
+
+static void
+gtk_media_controller_on_title_scroll_event(GtkEventControllerScroll* controller,
+                                           gdouble dx, gdouble dy, gpointer user_data){
+  GtkMediaController* self = GTK_MEDIA_CONTROLLER(user_data);
+  MEDIA_WATCHDOG_SCOPE("gtk_media_controller_on_title_scroll_event", NULL);
+
+  gint64 length = 0;
+  if(dx == 0 || !gtk_media_controller_get_seek_range(self, &length)) return;
+
+  // Every event moves from the position already shown, so a burst adds up
+  // before the player has answered
+  gint64 position = g_mpris_media_player_get_position_estimate(self->current_player);
+  position += (gint64)(dx * self->config->seek_step * G_USEC_PER_SEC);
+
+  g_mpris_media_player_set_position(self->current_player, position);
+  gtk_widget_queue_draw(GTK_WIDGET(self->container));
+}
+
+static gboolean
+gtk_media_controller_on_volume_timeout(gpointer user_data){
+  GtkMediaController* self = GTK_MEDIA_CONTROLLER(user_data);
+  MEDIA_WATCHDOG_SCOPE("gtk_media_controller_on_volume_timeout", NULL);
+  self->volume_timeout = 0;
+
+  MEDIA_STATS_INC(MEDIA_STAT_TIMER_WAKEUPS);
+  gtk_widget_hide(GTK_WIDGET(self->volume_label));
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+gtk_media_controller_on_volume_scroll_event(GtkEventControllerScroll* controller,
+                                            gdouble dx, gdouble dy, gpointer user_data){
+  GtkMediaController* self = GTK_MEDIA_CONTROLLER(user_data);
+  MEDIA_WATCHDOG_SCOPE("gtk_media_controller_on_volume_scroll_event", NULL);
+  if(dy == 0 || !self->current_player || !self->media_players) return;
+
+  gboolean can_control = FALSE;
+  gdouble volume = 0;
+  g_object_get(G_OBJECT(self->current_player), "can-control", &can_control, "volume", &volume, NULL);
+  if(!can_control) return;
+
+  // The player shows the new value at once, so a burst adds up locally.
+  // Scrolling stays within 0-100%, louder is left to the player itself
+  volume = CLAMP(volume - dy * self->config->volume_step / 100.0, 0.0, 1.0);
+  g_mpris_media_player_set_volume(self->current_player, volume);
+
+  gchar text[16];
+  g_snprintf(text, sizeof(text), "%d%%", (gint)round(volume * 100));
+  gtk_label_set_text(self->volume_label, text);
+  gtk_widget_show(GTK_WIDGET(self->volume_label));
+
+  if(self->volume_timeout) g_source_remove(self->volume_timeout);
+  self->volume_timeout = g_timeout_add(VOLUME_LABEL_TIMEOUT_MS, gtk_media_controller_on_volume_timeout, self);
+}
+
 static gboolean 
 gtk_media_controller_title_scroll(gpointer user_data){
   GtkMediaController* self = GTK_MEDIA_CONTROLLER(user_data);
+  MEDIA_WATCHDOG_SCOPE("gtk_media_controller_title_scroll", NULL);
+
+  MEDIA_STATS_INC(MEDIA_STAT_TIMER_WAKEUPS);
+  MEDIA_TRACE_SCOPE("title-scroll", NULL);
 
   if(!self || !self->title_scroll || !self->container || !gtk_widget_get_parent(GTK_WIDGET(self->container))) return TRUE;
 
@@ -737,14 +1624,25 @@ gtk_media_controller_on_query_tooltip(GtkWidget* widget, gint x, gint y, gboolea
   g_debug("gtk_media_controller_on_query_tooltip entered");
   
   GtkMediaController* self = GTK_MEDIA_CONTROLLER(user_data);
+  MEDIA_WATCHDOG_SCOPE("gtk_media_controller_on_query_tooltip", NULL);
   GError* err = NULL;
 
   if(self->current_player){
     gchar* art_url = NULL;
     g_object_get(G_OBJECT(self->current_player), "arturl", &art_url, NULL);
 
+    // The scaled art stays in the tooltip image until the track changes
+    if(art_url != NULL && self->tooltip_art_url != NULL && strcmp(art_url, self->tooltip_art_url) == 0){
+      MEDIA_STATS_INC(MEDIA_STAT_ART_CACHE_HITS);
+      g_free(art_url);
+      return TRUE;
+    }
+    g_clear_pointer(&self->tooltip_art_url, g_free);
+
     if(art_url != NULL){
       g_debug("Album art url = %s", art_url);
+      MEDIA_STATS_INC(MEDIA_STAT_ART_CACHE_MISSES);
+      MEDIA_TRACE_SCOPE("tooltip-art", NULL);
       GdkPixbuf* pixbuf = NULL;
       if (g_str_has_prefix(art_url, "file://")) {
         pixbuf = gdk_pixbuf_new_from_file(art_url + strlen("file://"), &err);
@@ -755,7 +1653,6 @@ gtk_media_controller_on_query_tooltip(GtkWidget* widget, gint x, gint y, gboolea
           return FALSE;
         }
       }
-      g_free(art_url);
 
       if(pixbuf){
         gint width, height, image_width, image_height;
@@ -773,12 +1670,16 @@ gtk_media_controller_on_query_tooltip(GtkWidget* widget, gint x, gint y, gboolea
           gtk_image_set_from_pixbuf(GTK_IMAGE(self->tooltip_image), pixbuf_scaled);
           gtk_widget_set_size_request(GTK_WIDGET(self->tooltip_image), width, height);
           g_object_unref(pixbuf_scaled);
+          self->tooltip_art_url = art_url;
         } else {
           g_critical("Pixbuf can not be read.\n");
+          g_free(art_url);
+          g_object_unref(pixbuf);
           return FALSE;
         }
         g_object_unref(pixbuf);
       } else {
+        g_free(art_url);
         return FALSE;
       }
     } else {
@@ -789,6 +1690,25 @@ gtk_media_controller_on_query_tooltip(GtkWidget* widget, gint x, gint y, gboolea
   return TRUE;
 }
 
+/*
+ * Metadata the players need to parse, the length is always shown by the
+ * progress strip.
+ */
+static guint
+gtk_media_controller_get_player_fields(MediaPlayerModConfig* config){
+  guint used = media_title_format_get_fields(config->title_template);
+  // The track id is sent back when seeking
+  guint fields = G_MPRIS_MEDIA_PLAYER_FIELD_LENGTH | G_MPRIS_MEDIA_PLAYER_FIELD_TRACK_ID;
+
+  if(used & MEDIA_TITLE_FIELD_MASK(MEDIA_TITLE_FIELD_ARTIST)) fields |= G_MPRIS_MEDIA_PLAYER_FIELD_ARTIST;
+  if(used & MEDIA_TITLE_FIELD_MASK(MEDIA_TITLE_FIELD_TITLE)) fields |= G_MPRIS_MEDIA_PLAYER_FIELD_TITLE;
+  if(used & MEDIA_TITLE_FIELD_MASK(MEDIA_TITLE_FIELD_ALBUM)) fields |= G_MPRIS_MEDIA_PLAYER_FIELD_ALBUM;
+  if(used & MEDIA_TITLE_FIELD_MASK(MEDIA_TITLE_FIELD_TRACK)) fields |= G_MPRIS_MEDIA_PLAYER_FIELD_TRACK_NUMBER;
+  if(config->tooltip) fields |= G_MPRIS_MEDIA_PLAYER_FIELD_ART_URL;
+
+  return fields;
+}
+
 GtkMediaController*
 gtk_media_controller_new(MediaPlayerModConfig* config){
   g_debug("gtk_media_controller_new entered");
@@ -800,11 +1720,28 @@ gtk_media_controller_new(MediaPlayerModConfig* config){
                                   "state", GTK_MEDIA_CONTROLLER_STATE_IDLE,
                                   NULL);
 
+  media_view_model_init(&self->view, config->title_template);
+  self->player_fields = gtk_media_controller_get_player_fields(config);
+  self->title_style = media_title_style_new(config->title_styles);
+
   self->container = GTK_CONTAINER(gtk_box_new(GTK_ORIENTATION_HORIZONTAL,5));
   gtk_widget_set_name(GTK_WIDGET(self->container),"media_player");
   g_signal_connect(self->container,"draw",G_CALLBACK(gtk_media_controller_on_draw_progress), self);
 
-  g_object_ref(self->container);
+  // The box has no window, capture sees the presses on its children first
+  self->progress_gesture = gtk_gesture_multi_press_new(GTK_WIDGET(self->container));
+  gtk_gesture_single_set_button(GTK_GESTURE_SINGLE(self->progress_gesture), GDK_BUTTON_PRIMARY);
+  gtk_event_controller_set_propagation_phase(GTK_EVENT_CONTROLLER(self->progress_gesture), GTK_PHASE_CAPTURE);
+  g_signal_connect(self->progress_gesture, "pressed", G_CALLBACK(gtk_media_controller_on_progress_pressed), self);
+
+  // Also captured, the title scroll window would take vertical scrolls too
+  self->volume_controller = gtk_event_controller_scroll_new(GTK_WIDGET(self->container),
+                                                            GTK_EVENT_CONTROLLER_SCROLL_VERTICAL);
+  gtk_event_controller_set_propagation_phase(self->volume_controller, GTK_PHASE_CAPTURE);
+  g_signal_connect(self->volume_controller, "scroll", G_CALLBACK(gtk_media_controller_on_volume_scroll_event), self);
+
+  // Owned by the controller, it is only parented while a player is shown
+  g_object_ref_sink(self->container);
 
   if(config->tooltip){
     g_signal_connect(self->container,"query-tooltip", G_CALLBACK(gtk_media_controller_on_query_tooltip), self);
@@ -825,10 +1762,25 @@ gtk_media_controller_new(MediaPlayerModConfig* config){
   GtkEventBox* player_event = GTK_EVENT_BOX(gtk_event_box_new());
   gtk_container_add(GTK_CONTAINER(self->container), GTK_WIDGET(player_event));
   g_signal_connect(GTK_WIDGET(player_event), "button-press-event", G_CALLBACK(gtk_media_controller_on_player_bp), self);
+  // The box has no window of its own, scrolls reach it through its children
+  gtk_widget_add_events(GTK_WIDGET(player_event), GDK_SCROLL_MASK | GDK_SMOOTH_SCROLL_MASK);
+
+  GtkContainer* player_box = GTK_CONTAINER(gtk_box_new(GTK_ORIENTATION_HORIZONTAL,3));
+  gtk_container_add(GTK_CONTAINER(player_event), GTK_WIDGET(player_box));
+
+  GtkStyleContext* context;
+  if(config->player_icon){
+    self->icon_cache = media_icon_cache_new(config->player_icon_size, gtk_media_controller_on_icons_changed, self);
+    self->player_icon = GTK_IMAGE(gtk_image_new());
+    gtk_widget_set_no_show_all(GTK_WIDGET(self->player_icon), TRUE);
+    gtk_container_add(player_box, GTK_WIDGET(self->player_icon));
+    context = gtk_widget_get_style_context(GTK_WIDGET(self->player_icon));
+    gtk_style_context_add_class(context,"player-icon");
+  }
 
   self->player_text = GTK_LABEL(gtk_label_new(""));
-  gtk_container_add(GTK_CONTAINER(player_event), GTK_WIDGET(self->player_text));
-  GtkStyleContext* context = gtk_widget_get_style_context(GTK_WIDGET(self->player_text));
+  gtk_container_add(player_box, GTK_WIDGET(self->player_text));
+  context = gtk_widget_get_style_context(GTK_WIDGET(self->player_text));
   gtk_style_context_add_class(context,"players");
 
   GtkContainer* button_container = GTK_CONTAINER(gtk_box_new(GTK_ORIENTATION_HORIZONTAL,1));
@@ -859,27 +1811,232 @@ gtk_media_controller_new(MediaPlayerModConfig* config){
   gtk_container_add(GTK_CONTAINER(self->container), GTK_WIDGET(title_event));
   g_signal_connect(GTK_WIDGET(title_event), "button-press-event", G_CALLBACK(gtk_media_controller_on_title_bp), self);
 
-  self->title_scroll = GTK_SCROLLED_WINDOW(gtk_scrolled_window_new(
-                        gtk_adjustment_new(0, 0, 0, 1.0, 0, 0), 
-                        gtk_adjustment_new(0, 0, 0, 0, 0, 0)));
-  gtk_container_add(GTK_CONTAINER(title_event), GTK_WIDGET(self->title_scroll));
-  gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(self->title_scroll), GTK_POLICY_EXTERNAL, GTK_POLICY_EXTERNAL);
+  // Captured before the title scroll window takes horizontal scrolls for itself
+  gtk_widget_add_events(GTK_WIDGET(title_event), GDK_SCROLL_MASK | GDK_SMOOTH_SCROLL_MASK);
+  self->title_scroll_controller = gtk_event_controller_scroll_new(GTK_WIDGET(title_event),
+                                                                  GTK_EVENT_CONTROLLER_SCROLL_HORIZONTAL);
+  gtk_event_controller_set_propagation_phase(self->title_scroll_controller, GTK_PHASE_CAPTURE);
+  g_signal_connect(self->title_scroll_controller, "scroll", G_CALLBACK(gtk_media_controller_on_title_scroll_event), self);
 
   self->title = GTK_LABEL(gtk_label_new(""));
-  gtk_container_add(GTK_CONTAINER(self->title_scroll), GTK_WIDGET(self->title));
+
+  if(config->title_ellipsize == TITLE_ELLIPSIZE_NONE){
+    self->title_scroll = GTK_SCROLLED_WINDOW(gtk_scrolled_window_new(
+                          gtk_adjustment_new(0, 0, 0, 1.0, 0, 0), 
+                          gtk_adjustment_new(0, 0, 0, 0, 0, 0)));
+    gtk_container_add(GTK_CONTAINER(title_event), GTK_WIDGET(self->title_scroll));
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(self->title_scroll), GTK_POLICY_EXTERNAL, GTK_POLICY_EXTERNAL);
+    gtk_container_add(GTK_CONTAINER(self->title_scroll), GTK_WIDGET(self->title));
+  } else {
+    // The label sits in the bar directly and is given text that fits
+    self->title_clusters = g_array_new(FALSE, FALSE, sizeof(TitleCluster));
+    self->title_display = g_string_sized_new(128);
+    gtk_container_add(GTK_CONTAINER(title_event), GTK_WIDGET(self->title));
+  }
   context = gtk_widget_get_style_context(GTK_WIDGET(self->title));
   gtk_style_context_add_class(context,"title");
   gtk_widget_set_halign (GTK_WIDGET(self->title), GTK_ALIGN_START);
 
-  if(self->config->scroll_title){
-    gtk_media_controller_reset_title_scroll(self, FALSE);
-
-   self->scroll_timeout = g_timeout_add(self->config->scroll_interval,gtk_media_controller_title_scroll, self);
+  if(config->time_format != TIME_FORMAT_NONE){
+    self->time_label = GTK_LABEL(gtk_label_new(""));
+    gtk_container_add(GTK_CONTAINER(self->container), GTK_WIDGET(self->time_label));
+    context = gtk_widget_get_style_context(GTK_WIDGET(self->time_label));
+    gtk_style_context_add_class(context,"time");
+    gtk_label_set_xalign(self->time_label, 1.0);
+
+    PangoAttrList* attrs = pango_attr_list_new();
+    pango_attr_list_insert(attrs, pango_attr_font_features_new("tnum"));
+    gtk_label_set_attributes(self->time_label, attrs);
+    pango_attr_list_unref(attrs);
   }
 
+  self->volume_label = GTK_LABEL(gtk_label_new(""));
+  gtk_widget_set_no_show_all(GTK_WIDGET(self->volume_label), TRUE);
+  gtk_container_add(GTK_CONTAINER(self->container), GTK_WIDGET(self->volume_label));
+  context = gtk_widget_get_style_context(GTK_WIDGET(self->volume_label));
+  gtk_style_context_add_class(context,"volume");
+
+  // Paint the last known player right away, the bus is only queried once
+  // the main loop is running
+  MediaSnapshotData snapshot_data;
+  self->snapshot = media_snapshot_open(config->instance);
+  self->snapshot_active = media_snapshot_peek(self->snapshot, &snapshot_data);
+  self->start_source = g_idle_add(gtk_media_controller_start, self);
 
   gtk_media_controller_update(self);
 
   return self;
 }
 
+static gsize
+gtk_media_controller_label_size(GtkLabel* label){
+  if(!label) return 0;
+
+  PangoLayout* layout = gtk_label_get_layout(label);
+  return strlen(pango_layout_get_text(layout)) + 1 +
+         pango_layout_get_line_count(layout) * sizeof(PangoLayoutLine);
+}
+
+/*
+ * Estimates the bytes retained by the controller itself, players are
+ * accounted on their own.
+ */
+static void
+gtk_media_controller_append_memory(GtkMediaController* self, GString* out){
+  gsize pixbufs = 0;
+  if(self->tooltip_image && gtk_image_get_storage_type(self->tooltip_image) == GTK_IMAGE_PIXBUF){
+    GdkPixbuf* pixbuf = gtk_image_get_pixbuf(self->tooltip_image);
+    if(pixbuf) pixbufs += gdk_pixbuf_get_byte_length(pixbuf);
+  }
+
+  gsize layouts = gtk_media_controller_label_size(self->title) +
+                  gtk_media_controller_label_size(self->player_text);
+
+  gsize strings = (self->view.title ? self->view.title->allocated_len : 0) +
+                  (self->tooltip_art_url ? strlen(self->tooltip_art_url) + 1 : 0);
+  for(guint i = 0; i < MEDIA_TITLE_FIELD_LAST; i++){
+    if(self->view.fields[i]) strings += self->view.fields[i]->allocated_len;
+  }
+
+  gsize snapshot = self->snapshot ? sizeof(MediaSnapshotData) : 0;
+
+  pixbufs += media_icon_cache_get_memory(self->icon_cache);
+
+  g_string_append_printf(out,
+      "controller memory: total=%" G_GSIZE_FORMAT " object=%" G_GSIZE_FORMAT
+      " pixbufs=%" G_GSIZE_FORMAT " layouts=%" G_GSIZE_FORMAT
+      " strings=%" G_GSIZE_FORMAT " snapshot=%" G_GSIZE_FORMAT "\n",
+      sizeof(GtkMediaController) + pixbufs + layouts + strings + snapshot,
+      sizeof(GtkMediaController), pixbufs, layouts, strings, snapshot);
+}
+
+static void
+gtk_media_controller_action_play_pause(GtkMediaController* self, const gchar* arg){
+  g_mpris_media_player_play_pause(self->current_player);
+}
+
+static void
+gtk_media_controller_action_next(GtkMediaController* self, const gchar* arg){
+  g_mpris_media_player_next(self->current_player);
+  gtk_media_controller_reset_title_scroll(self, FALSE);
+}
+
+static void
+gtk_media_controller_action_previous(GtkMediaController* self, const gchar* arg){
+  g_mpris_media_player_previous(self->current_player);
+  gtk_media_controller_reset_title_scroll(self, FALSE);
+}
+
+static void
+gtk_media_controller_action_stop(GtkMediaController* self, const gchar* arg){
+  g_mpris_media_player_stop(self->current_player);
+}
+
+static void
+gtk_media_controller_action_next_player(GtkMediaController* self, const gchar* arg){
+  gtk_media_controller_select_next_player(self, self->current_player);
+  gtk_media_controller_update(self);
+}
+
+static void
+gtk_media_controller_action_seek(GtkMediaController* self, const gchar* arg){
+  gchar* end = NULL;
+  gint64 seconds = g_ascii_strtoll(arg, &end, 10);
+
+  if((arg[0] != '+' && arg[0] != '-') || end == arg + 1 || *end != '\0'){
+    g_warning("Invalid seek action seek%s, expected seek+N or seek-N", arg);
+    return;
+  }
+
+  gint64 length = 0;
+  if(!gtk_media_controller_get_seek_range(self, &length)) return;
+
+  gint64 position = g_mpris_media_player_get_position_estimate(self->current_player);
+  g_mpris_media_player_set_position(self->current_player, position + seconds * G_USEC_PER_SEC);
+  gtk_widget_queue_draw(GTK_WIDGET(self->container));
+}
+
+static void
+gtk_media_controller_action_raise(GtkMediaController* self, const gchar* arg){
+  g_mpris_media_player_raise(self->current_player);
+}
+
+/*
+ * Actions Waybar can send, prefix entries take the rest of the name as
+ * their argument.
+ */
+static const struct
+{
+  const gchar* name;
+  gboolean prefix;
+  void (*run)(GtkMediaController* self, const gchar* arg);
+} gtk_media_controller_actions[] = {
+  { "play-pause",  FALSE, gtk_media_controller_action_play_pause },
+  { "next",        FALSE, gtk_media_controller_action_next },
+  { "previous",    FALSE, gtk_media_controller_action_previous },
+  { "stop",        FALSE, gtk_media_controller_action_stop },
+  { "next-player", FALSE, gtk_media_controller_action_next_player },
+  { "seek",        TRUE,  gtk_media_controller_action_seek },
+  { "raise",       FALSE, gtk_media_controller_action_raise },
+};
+
+/*
+ * Runs a named action on the current player in process. Returns FALSE for
+ * unknown names; known actions without a player to act on are ignored.
+ */
+gboolean
+gtk_media_controller_do_action(GtkMediaController* self, const gchar* name){
+  g_return_val_if_fail(GTK_IS_MEDIA_CONTROLLER(self), FALSE);
+  if(!name) return FALSE;
+
+  MEDIA_WATCHDOG_SCOPE("gtk_media_controller_do_action", name);
+
+  for(guint i = 0; i < G_N_ELEMENTS(gtk_media_controller_actions); i++){
+    const gchar* action = gtk_media_controller_actions[i].name;
+    const gchar* arg = "";
+
+    if(gtk_media_controller_actions[i].prefix){
+      if(!g_str_has_prefix(name, action)) continue;
+      arg = name + strlen(action);
+    } else if(strcmp(name, action) != 0){
+      continue;
+    }
+
+    if(self->current_player && self->media_players){
+      gtk_media_controller_actions[i].run(self, arg);
+    } else {
+      g_debug("Action %s ignored, there is no player", name);
+    }
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/*
+ * Dumps the module counters and the per player ones to the runtime dir.
+ */
+void
+gtk_media_controller_dump_stats(GtkMediaController* self){
+  g_return_if_fail(GTK_IS_MEDIA_CONTROLLER(self));
+
+  GString* out = g_string_new(NULL);
+
+  media_stats_append(out);
+  media_watchdog_append(out);
+  gtk_media_controller_append_memory(self, out);
+
+  gsize players_memory = 0;
+  for(GList* l = self->media_players; l; l = l->next){
+    players_memory += g_mpris_media_player_get_memory(G_MPRIS_MEDIA_PLAYER(l->data), NULL);
+  }
+  g_string_append_printf(out, "players: %u memory=%" G_GSIZE_FORMAT "\n",
+                         g_list_length(self->media_players), players_memory);
+
+  for(GList* l = self->media_players; l; l = l->next){
+    g_mpris_media_player_append_stats(G_MPRIS_MEDIA_PLAYER(l->data), out);
+  }
+
+  media_stats_write(out);
+  g_string_free(out, TRUE);
+}
@@ -49,5 +49,7 @@ GtkMediaController* gtk_media_controller_new(MediaPlayerModConfig*);
 gboolean gtk_media_controller_pause(GtkMediaController* self);
 gboolean gtk_media_controller_play(GtkMediaController* self);
 gboolean gtk_media_controller_toogle(GtkMediaController* self);
+void gtk_media_controller_dump_stats(GtkMediaController* self);
+gboolean gtk_media_controller_do_action(GtkMediaController* self, const gchar* name);
 
 G_END_DECLS
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define G_LOG_DOMAIN "waybarmediaplayer.media-icon-cache"
+
+#include <gtk/gtk.h>
+#include <gio/gdesktopappinfo.h>
+#include <string.h>
+
+#include "media_icon_cache.h"
+#include "media_stats.h"
+
+struct _MediaIconCache
+{
+  gint size;
+  GtkIconTheme* theme;
+  gulong theme_changed_id;
+
+  // Lookup key to GdkPixbuf, NULL values remember the misses
+  GHashTable* icons;
+
+  MediaIconCacheChanged changed;
+  gpointer user_data;
+};
+
+static void
+media_icon_cache_free_icon(gpointer pixbuf){
+  if(pixbuf) g_object_unref(pixbuf);
+}
+
+static void
+media_icon_cache_on_theme_changed(GtkIconTheme* theme, gpointer user_data){
+  MediaIconCache* self = user_data;
+
+  g_debug("Icon theme changed, dropping %u cached icons", g_hash_table_size(self->icons));
+  g_hash_table_remove_all(self->icons);
+
+  if(self->changed) self->changed(self->user_data);
+}
+
+/*
+ * Icons are looked up once per player identity and kept at the given size
+ * until the icon theme changes.
+ */
+MediaIconCache*
+media_icon_cache_new(gint size, MediaIconCacheChanged changed, gpointer user_data){
+  MediaIconCache* self = g_new0(MediaIconCache, 1);
+  self->size = size;
+  self->theme = g_object_ref(gtk_icon_theme_get_default());
+  self->icons = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, media_icon_cache_free_icon);
+  self->changed = changed;
+  self->user_data = user_data;
+
+  self->theme_changed_id = g_signal_connect(self->theme, "changed",
+                             G_CALLBACK(media_icon_cache_on_theme_changed), self);
+
+  return self;
+}
+
+void
+media_icon_cache_free(MediaIconCache* self){
+  if(!self) return;
+
+  g_signal_handler_disconnect(self->theme, self->theme_changed_id);
+  g_object_unref(self->theme);
+  g_hash_table_unref(self->icons);
+  g_free(self);
+}
+
+static GDesktopAppInfo*
+media_icon_cache_find_app(const gchar* name){
+  gchar* desktop_id = g_strconcat(name, ".desktop", NULL);
+  GDesktopAppInfo* info = g_desktop_app_info_new(desktop_id);
+  g_free(desktop_id);
+
+  return info;
+}
+
+/*
+ * Resolves the icon the way a launcher would: the DesktopEntry file first,
+ * then a desktop file or a themed icon named after the identity.
+ */
+static GdkPixbuf*
+media_icon_cache_load(MediaIconCache* self, const gchar* desktop_entry, const gchar* identity){
+  MEDIA_STATS_INC(MEDIA_STAT_ICON_LOOKUPS);
+
+  GDesktopAppInfo* info = NULL;
+  gchar* name = NULL;
+
+  if(desktop_entry && desktop_entry[0]){
+    info = media_icon_cache_find_app(desktop_entry);
+    name = g_ascii_strdown(desktop_entry, -1);
+  } else if(identity && identity[0]){
+    name = g_ascii_strdown(identity, -1);
+    g_strdelimit(name, " ", '-');
+  }
+
+  if(!info && name) info = media_icon_cache_find_app(name);
+
+  GIcon* icon = NULL;
+  if(info && g_app_info_get_icon(G_APP_INFO(info))){
+    icon = g_object_ref(g_app_info_get_icon(G_APP_INFO(info)));
+  } else if(name){
+    icon = g_themed_icon_new(name);
+  }
+
+  GdkPixbuf* pixbuf = NULL;
+  if(icon){
+    GtkIconInfo* icon_info = gtk_icon_theme_lookup_by_gicon(self->theme, icon, self->size, GTK_ICON_LOOKUP_FORCE_SIZE);
+    if(icon_info){
+      GError* err = NULL;
+      pixbuf = gtk_icon_info_load_icon(icon_info, &err);
+      if(!pixbuf){
+        g_debug("Can not load the icon of %s: %s", name, err->message);
+        g_error_free(err);
+      }
+      g_object_unref(icon_info);
+    }
+    g_object_unref(icon);
+  }
+
+  if(info) g_object_unref(info);
+  g_free(name);
+
+  return pixbuf;
+}
+
+// Borrowed, NULL when the player has no icon
+GdkPixbuf*
+media_icon_cache_lookup(MediaIconCache* self, const gchar* desktop_entry, const gchar* identity){
+  const gchar* key = desktop_entry && desktop_entry[0] ? desktop_entry : identity;
+  if(!key || !key[0]) return NULL;
+
+  gpointer pixbuf;
+  if(g_hash_table_lookup_extended(self->icons, key, NULL, &pixbuf)) return pixbuf;
+
+  pixbuf = media_icon_cache_load(self, desktop_entry, identity);
+  g_hash_table_insert(self->icons, g_strdup(key), pixbuf);
+
+  g_debug("Icon for %s %s", key, pixbuf ? "found" : "not found");
+  return pixbuf;
+}
+
+gsize
+media_icon_cache_get_memory(MediaIconCache* self){
+  if(!self) return 0;
+
+  gsize size = 0;
+  GHashTableIter iter;
+  gpointer key, value;
+
+  g_hash_table_iter_init(&iter, self->icons);
+  while(g_hash_table_iter_next(&iter, &key, &value)){
+    size += strlen(key) + 1;
+    if(value) size += gdk_pixbuf_get_byte_length(value);
+  }
+
+  return size;
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+typedef void (*MediaIconCacheChanged)(gpointer user_data);
+
+typedef struct _MediaIconCache MediaIconCache;
+
+MediaIconCache* media_icon_cache_new(gint size, MediaIconCacheChanged changed, gpointer user_data);
+void media_icon_cache_free(MediaIconCache* self);
+
+GdkPixbuf* media_icon_cache_lookup(MediaIconCache* self, const gchar* desktop_entry, const gchar* identity);
+gsize media_icon_cache_get_memory(MediaIconCache* self);
+
+G_END_DECLS
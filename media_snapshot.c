@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define G_LOG_DOMAIN "waybarmediaplayer.media-snapshot"
+
+#include <glib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "media_snapshot.h"
+
+struct _MediaSnapshot
+{
+  gint fd;
+  MediaSnapshotData* data;
+};
+
+static guint32
+media_snapshot_checksum(const MediaSnapshotData* data){
+  // FNV-1a, enough to tell a half written record from a whole one
+  const guint8* bytes = (const guint8*)data;
+  guint32 hash = 2166136261u;
+
+  for(gsize i = 0; i < sizeof(MediaSnapshotData); i++){
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+/*
+ * Every module instance owns its file, so bars never map each other's
+ * record. instance is the position of the module among the loaded ones,
+ * stable across reloads of the same configuration.
+ */
+MediaSnapshot*
+media_snapshot_open(guint instance){
+  g_debug("media_snapshot_open entered");
+
+  gchar* name = g_strdup_printf(MEDIA_SNAPSHOT_FILE, instance);
+  gchar* path = g_build_filename(g_get_user_runtime_dir(), name, NULL);
+  g_free(name);
+
+  gint fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+  if(fd < 0){
+    g_warning("Can not open snapshot file %s: %s", path, g_strerror(errno));
+    g_free(path);
+    return NULL;
+  }
+
+  struct stat st;
+  if(fstat(fd, &st) != 0 || st.st_size != sizeof(MediaSnapshotData)){
+    // New or stale file, start from an empty snapshot
+    if(ftruncate(fd, 0) != 0 || ftruncate(fd, sizeof(MediaSnapshotData)) != 0){
+      g_warning("Can not resize snapshot file %s: %s", path, g_strerror(errno));
+      close(fd);
+      g_free(path);
+      return NULL;
+    }
+  }
+
+  void* map = mmap(NULL, sizeof(MediaSnapshotData), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if(map == MAP_FAILED){
+    g_warning("Can not map snapshot file %s: %s", path, g_strerror(errno));
+    close(fd);
+    g_free(path);
+    return NULL;
+  }
+
+  g_free(path);
+
+  MediaSnapshot* self = g_new0(MediaSnapshot, 1);
+  self->fd = fd;
+  self->data = map;
+
+  g_debug("media_snapshot_open exited");
+  return self;
+}
+
+void
+media_snapshot_close(MediaSnapshot* self){
+  if(!self) return;
+
+  munmap(self->data, sizeof(MediaSnapshotData));
+  close(self->fd);
+  g_free(self);
+}
+
+/*
+ * Copies the stored record to out. Returns FALSE when there is none or it
+ * does not validate, out is undefined then.
+ */
+gboolean
+media_snapshot_peek(MediaSnapshot* self, MediaSnapshotData* out){
+  if(!self) return FALSE;
+
+  memcpy(out, self->data, sizeof(MediaSnapshotData));
+
+  if(out->magic != MEDIA_SNAPSHOT_MAGIC || out->version != MEDIA_SNAPSHOT_VERSION) return FALSE;
+  if(out->player_count == 0) return FALSE;
+
+  guint32 checksum = out->checksum;
+  out->checksum = 0;
+  if(media_snapshot_checksum(out) != checksum) return FALSE;
+  out->checksum = checksum;
+
+  // The file can be edited by anyone, never trust its strings to be terminated
+  if(out->identity[sizeof(out->identity)-1] != '\0' ||
+     out->artist[sizeof(out->artist)-1] != '\0' ||
+     out->title[sizeof(out->title)-1] != '\0') return FALSE;
+
+  return TRUE;
+}
+
+void
+media_snapshot_store(MediaSnapshot* self, const MediaSnapshotData* data){
+  if(!self || !data) return;
+
+  MediaSnapshotData record = *data;
+  record.checksum = 0;
+  record.checksum = media_snapshot_checksum(&record);
+
+  // Most updates do not change what is displayed, keep the page clean
+  if(memcmp(self->data, &record, sizeof(MediaSnapshotData)) == 0) return;
+
+  memcpy(self->data, &record, sizeof(MediaSnapshotData));
+  g_debug("Snapshot updated: %s - %s", data->artist, data->title);
+}
+
+// Surrounding whitespace is dropped, the rest of dest is zeroed
+void
+media_snapshot_set_string(gchar* dest, gsize dest_size, const gchar* src){
+  memset(dest, 0, dest_size);
+  if(!src) return;
+
+  while(g_ascii_isspace(*src)) src++;
+  g_strlcpy(dest, src, dest_size);
+  g_strchomp(dest);
+
+  const gchar* end = NULL;
+  if(!g_utf8_validate(dest, -1, &end)){
+    // Drop the partial character left by the truncation
+    memset((gchar*)end, 0, dest_size - (end - dest));
+  }
+}
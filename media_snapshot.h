@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+#define MEDIA_SNAPSHOT_MAGIC    0x504d4257 /* "WBMP" */
+#define MEDIA_SNAPSHOT_VERSION  2
+#define MEDIA_SNAPSHOT_FILE     "waybar_mediaplayer-%u.snapshot"
+
+typedef enum _MediaSnapshotCaps
+{
+  MEDIA_SNAPSHOT_CAN_GO_NEXT     = 1 << 0,
+  MEDIA_SNAPSHOT_CAN_GO_PREVIOUS = 1 << 1,
+  MEDIA_SNAPSHOT_CAN_PLAY        = 1 << 2,
+  MEDIA_SNAPSHOT_CAN_CONTROL     = 1 << 3,
+} MediaSnapshotCaps;
+
+/*
+ * On-disk layout of the last displayed player. Fixed size so it can be
+ * mapped and compared in place; strings are NUL terminated and truncated
+ * on a UTF-8 boundary. checksum covers the record with the field zeroed,
+ * a write torn by a crash is dropped on the next start.
+ */
+typedef struct _MediaSnapshotData
+{
+  guint32 magic;
+  guint16 version;
+  guint8  state;
+  guint8  caps;
+  guint16 player_pos;
+  guint16 player_count;
+  guint32 art_key;
+  guint32 checksum;
+  gchar   identity[64];
+  gchar   artist[128];
+  gchar   title[192];
+} MediaSnapshotData;
+
+typedef struct _MediaSnapshot MediaSnapshot;
+
+MediaSnapshot* media_snapshot_open(guint instance);
+void media_snapshot_close(MediaSnapshot* self);
+
+gboolean media_snapshot_peek(MediaSnapshot* self, MediaSnapshotData* out);
+void media_snapshot_store(MediaSnapshot* self, const MediaSnapshotData* data);
+
+void media_snapshot_set_string(gchar* dest, gsize dest_size, const gchar* src);
+
+G_END_DECLS
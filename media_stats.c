@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define G_LOG_DOMAIN "waybarmediaplayer.media-stats"
+
+#include <glib.h>
+
+#include "media_stats.h"
+
+guint64 media_stats[MEDIA_STAT_LAST] = {0, };
+
+static const gchar* media_stat_names[MEDIA_STAT_LAST] = {
+  [MEDIA_STAT_DBUS_SIGNALS]       = "dbus-signals",
+  [MEDIA_STAT_UPDATE_INFO]        = "update-info",
+  [MEDIA_STAT_CONTROLLER_UPDATES] = "controller-updates",
+  [MEDIA_STAT_GTK_MUTATIONS]      = "gtk-mutations",
+  [MEDIA_STAT_REDRAWS]            = "redraws",
+  [MEDIA_STAT_TIMER_WAKEUPS]      = "timer-wakeups",
+  [MEDIA_STAT_ART_CACHE_HITS]     = "art-cache-hits",
+  [MEDIA_STAT_ART_CACHE_MISSES]   = "art-cache-misses",
+  [MEDIA_STAT_METADATA_BYTES]     = "metadata-bytes",
+  [MEDIA_STAT_ICON_LOOKUPS]       = "icon-lookups",
+  [MEDIA_STAT_SEEKS_SENT]         = "seeks-sent",
+  [MEDIA_STAT_SEEKS_COLLAPSED]    = "seeks-collapsed",
+  [MEDIA_STAT_VOLUME_WRITES]      = "volume-writes",
+  [MEDIA_STAT_VOLUME_COLLAPSED]   = "volume-collapsed",
+};
+
+void
+media_stats_append(GString* out){
+  for(guint i = 0; i < MEDIA_STAT_LAST; i++){
+    g_string_append_printf(out, "%s: %" G_GUINT64_FORMAT "\n", media_stat_names[i], media_stats[i]);
+  }
+}
+
+/*
+ * Replaces $XDG_RUNTIME_DIR/waybar_mediaplayer.stats with the dump, readers
+ * never see a partial file.
+ */
+void
+media_stats_write(const GString* out){
+  gchar* path = g_build_filename(g_get_user_runtime_dir(), MEDIA_STATS_FILE, NULL);
+  GError* err = NULL;
+
+  if(!g_file_set_contents(path, out->str, out->len, &err)){
+    g_warning("Can not write stats to %s: %s", path, err->message);
+    g_error_free(err);
+  } else {
+    g_info("Stats written to %s", path);
+  }
+
+  g_free(path);
+}
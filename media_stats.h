@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+#define MEDIA_STATS_FILE "waybar_mediaplayer.stats"
+
+typedef enum _MediaStat
+{
+  MEDIA_STAT_DBUS_SIGNALS,
+  MEDIA_STAT_UPDATE_INFO,
+  MEDIA_STAT_CONTROLLER_UPDATES,
+  MEDIA_STAT_GTK_MUTATIONS,
+  MEDIA_STAT_REDRAWS,
+  MEDIA_STAT_TIMER_WAKEUPS,
+  MEDIA_STAT_ART_CACHE_HITS,
+  MEDIA_STAT_ART_CACHE_MISSES,
+  MEDIA_STAT_METADATA_BYTES,
+  MEDIA_STAT_ICON_LOOKUPS,
+  MEDIA_STAT_SEEKS_SENT,
+  MEDIA_STAT_SEEKS_COLLAPSED,
+  MEDIA_STAT_VOLUME_WRITES,
+  MEDIA_STAT_VOLUME_COLLAPSED,
+  MEDIA_STAT_LAST
+} MediaStat;
+
+/*
+ * Always on counters. Everything runs on the main loop, so they are plain
+ * increments.
+ */
+extern guint64 media_stats[MEDIA_STAT_LAST];
+
+#define MEDIA_STATS_INC(stat)    (media_stats[(stat)]++)
+#define MEDIA_STATS_ADD(stat, n) (media_stats[(stat)] += (n))
+
+void media_stats_append(GString* out);
+void media_stats_write(const GString* out);
+
+G_END_DECLS
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define G_LOG_DOMAIN "waybarmediaplayer.media-timeline"
+
+#include <glib.h>
+#include <string.h>
+
+#include "media_timeline.h"
+
+static const gchar* phase_names[MEDIA_TIMELINE_LAST] = {
+  [MEDIA_TIMELINE_CONFIG]        = "config",
+  [MEDIA_TIMELINE_CONTROLLER]    = "controller",
+  [MEDIA_TIMELINE_BUS]           = "bus",
+  [MEDIA_TIMELINE_LIST_NAMES]    = "list-names",
+  [MEDIA_TIMELINE_PLAYERS_READY] = "players-ready",
+  [MEDIA_TIMELINE_FIRST_UPDATE]  = "first-update",
+  [MEDIA_TIMELINE_FIRST_DRAW]    = "first-draw",
+  [MEDIA_TIMELINE_LIVE_DRAW]     = "live-draw",
+};
+
+// Journal field names of the phases
+static const gchar* phase_fields[MEDIA_TIMELINE_LAST] = {
+  [MEDIA_TIMELINE_CONFIG]        = "MEDIA_TIMELINE_CONFIG_MS",
+  [MEDIA_TIMELINE_CONTROLLER]    = "MEDIA_TIMELINE_CONTROLLER_MS",
+  [MEDIA_TIMELINE_BUS]           = "MEDIA_TIMELINE_BUS_MS",
+  [MEDIA_TIMELINE_LIST_NAMES]    = "MEDIA_TIMELINE_LIST_NAMES_MS",
+  [MEDIA_TIMELINE_PLAYERS_READY] = "MEDIA_TIMELINE_PLAYERS_READY_MS",
+  [MEDIA_TIMELINE_FIRST_UPDATE]  = "MEDIA_TIMELINE_FIRST_UPDATE_MS",
+  [MEDIA_TIMELINE_FIRST_DRAW]    = "MEDIA_TIMELINE_FIRST_DRAW_MS",
+  [MEDIA_TIMELINE_LIVE_DRAW]     = "MEDIA_TIMELINE_LIVE_DRAW_MS",
+};
+
+// Timestamps are relative to begin, 0 means the phase was not reached
+static gint64 begin_time = 0;
+static gint64 phases[MEDIA_TIMELINE_LAST];
+static GString* players = NULL;
+static guint player_count = 0;
+static const gchar* first_draw_source = NULL;
+static gboolean finished = TRUE;
+
+static gint64
+media_timeline_now(void){
+  return MAX(g_get_monotonic_time() - begin_time, 1);
+}
+
+void
+media_timeline_begin(void){
+  // Another bar is still starting, keep measuring that one
+  if(!finished) return;
+
+  begin_time = g_get_monotonic_time();
+  memset(phases, 0, sizeof(phases));
+  player_count = 0;
+  first_draw_source = NULL;
+  finished = FALSE;
+
+  if(players) g_string_truncate(players, 0);
+  else players = g_string_new(NULL);
+}
+
+void
+media_timeline_mark(MediaTimelinePhase phase){
+  if(finished || phases[phase]) return;
+  phases[phase] = media_timeline_now();
+}
+
+void
+media_timeline_mark_player(const gchar* bus_name){
+  if(finished) return;
+
+  g_string_append_printf(players, "%s%s=%.1f", player_count ? "," : "",
+                         bus_name, media_timeline_now() / 1000.0);
+  player_count++;
+}
+
+void
+media_timeline_set_first_draw_source(const gchar* source){
+  if(finished || first_draw_source) return;
+  first_draw_source = source;
+}
+
+/*
+ * Logs the timeline as one line, with one structured field per phase so
+ * it can be queried from the journal.
+ */
+void
+media_timeline_finish(void){
+  if(finished) return;
+  finished = TRUE;
+
+  GString* message = g_string_new("Startup timeline (ms):");
+  GLogField fields[MEDIA_TIMELINE_LAST + 4];
+  gchar values[MEDIA_TIMELINE_LAST][G_ASCII_DTOSTR_BUF_SIZE];
+  gsize n = 0;
+
+  for(guint i = 0; i < MEDIA_TIMELINE_LAST; i++){
+    if(!phases[i]){
+      g_string_append_printf(message, " %s=-", phase_names[i]);
+      continue;
+    }
+
+    g_ascii_formatd(values[i], sizeof(values[i]), "%.1f", phases[i] / 1000.0);
+    g_string_append_printf(message, " %s=%s", phase_names[i], values[i]);
+
+    fields[n].key = phase_fields[i];
+    fields[n].value = values[i];
+    fields[n].length = -1;
+    n++;
+  }
+
+  g_string_append_printf(message, " first-draw-source=%s players=%u [%s]",
+                         first_draw_source ? first_draw_source : "-", player_count, players->str);
+
+  fields[n++] = (GLogField){ "GLIB_DOMAIN", G_LOG_DOMAIN, -1 };
+  fields[n++] = (GLogField){ "PRIORITY", "6", -1 };
+  fields[n++] = (GLogField){ "MESSAGE", message->str, -1 };
+  fields[n++] = (GLogField){ "MEDIA_TIMELINE_PLAYERS", players->str, -1 };
+
+  g_log_structured_array(G_LOG_LEVEL_INFO, fields, n);
+
+  g_string_free(message, TRUE);
+}
+
+gboolean
+media_timeline_is_finished(void){
+  return finished;
+}
+
+// Microseconds from begin to the phase, 0 when it was not reached
+gint64
+media_timeline_get_phase(MediaTimelinePhase phase){
+  return phases[phase];
+}
+
+const gchar*
+media_timeline_get_phase_name(MediaTimelinePhase phase){
+  return phase_names[phase];
+}
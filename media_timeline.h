@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef enum _MediaTimelinePhase
+{
+  MEDIA_TIMELINE_CONFIG,
+  MEDIA_TIMELINE_CONTROLLER,
+  MEDIA_TIMELINE_BUS,
+  MEDIA_TIMELINE_LIST_NAMES,
+  MEDIA_TIMELINE_PLAYERS_READY,
+  MEDIA_TIMELINE_FIRST_UPDATE,
+  MEDIA_TIMELINE_FIRST_DRAW,
+  MEDIA_TIMELINE_LIVE_DRAW,
+  MEDIA_TIMELINE_LAST
+} MediaTimelinePhase;
+
+/*
+ * Startup phases from wbcffi_init on, each one is kept the first time it is
+ * reached. The timeline is per process: with several bars the first module
+ * instance is measured.
+ */
+void media_timeline_begin(void);
+void media_timeline_mark(MediaTimelinePhase phase);
+void media_timeline_mark_player(const gchar* bus_name);
+void media_timeline_set_first_draw_source(const gchar* source);
+void media_timeline_finish(void);
+
+gboolean media_timeline_is_finished(void);
+gint64 media_timeline_get_phase(MediaTimelinePhase phase);
+const gchar* media_timeline_get_phase_name(MediaTimelinePhase phase);
+
+G_END_DECLS
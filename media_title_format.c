@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define G_LOG_DOMAIN "waybarmediaplayer.media-title-format"
+
+#include <glib.h>
+#include <string.h>
+
+#include "media_title_format.h"
+
+static const gchar* field_names[MEDIA_TITLE_FIELD_LAST] = {
+  [MEDIA_TITLE_FIELD_ARTIST] = "artist",
+  [MEDIA_TITLE_FIELD_TITLE]  = "title",
+  [MEDIA_TITLE_FIELD_ALBUM]  = "album",
+  [MEDIA_TITLE_FIELD_TRACK]  = "track",
+  [MEDIA_TITLE_FIELD_PLAYER] = "player",
+};
+
+typedef enum _MediaTitleOpKind
+{
+  MEDIA_TITLE_OP_LITERAL,
+  MEDIA_TITLE_OP_FIELD,
+} MediaTitleOpKind;
+
+typedef struct _MediaTitleOp
+{
+  MediaTitleOpKind kind;
+  // Literal: range in the literal buffer. Field: the MediaTitleField.
+  guint offset;
+  guint length;
+} MediaTitleOp;
+
+struct _MediaTitleFormat
+{
+  GArray* ops;
+  GString* literals;
+  guint fields;
+};
+
+// MEDIA_TITLE_FIELD_LAST when name is not a field
+MediaTitleField
+media_title_format_field_from_name(const gchar* name, gsize len){
+  for(guint i = 0; i < MEDIA_TITLE_FIELD_LAST; i++){
+    if(strlen(field_names[i]) == len && g_ascii_strncasecmp(name, field_names[i], len) == 0) return i;
+  }
+
+  return MEDIA_TITLE_FIELD_LAST;
+}
+
+static void
+media_title_format_add_literal(MediaTitleFormat* self, const gchar* text, gsize len){
+  if(len == 0) return;
+
+  // Text split by escapes is merged back into one literal
+  if(self->ops->len > 0){
+    MediaTitleOp* last = &g_array_index(self->ops, MediaTitleOp, self->ops->len - 1);
+    if(last->kind == MEDIA_TITLE_OP_LITERAL && last->offset + last->length == self->literals->len){
+      g_string_append_len(self->literals, text, len);
+      last->length += len;
+      return;
+    }
+  }
+
+  MediaTitleOp op = { MEDIA_TITLE_OP_LITERAL, self->literals->len, len };
+  g_string_append_len(self->literals, text, len);
+  g_array_append_val(self->ops, op);
+}
+
+/*
+ * Compiles a template such as "{artist} - {title} [{album}]" into a list of
+ * literal and field ops. "{{" and "}}" stand for literal braces, unknown
+ * fields are kept as text.
+ */
+MediaTitleFormat*
+media_title_format_compile(const gchar* format){
+  if(!format || !format[0]) format = MEDIA_TITLE_FORMAT_DEFAULT;
+
+  MediaTitleFormat* self = g_new0(MediaTitleFormat, 1);
+  self->ops = g_array_new(FALSE, FALSE, sizeof(MediaTitleOp));
+  self->literals = g_string_new(NULL);
+
+  const gchar* p = format;
+  while(*p){
+    if((p[0] == '{' && p[1] == '{') || (p[0] == '}' && p[1] == '}')){
+      media_title_format_add_literal(self, p, 1);
+      p += 2;
+      continue;
+    }
+
+    if(p[0] == '{'){
+      const gchar* end = strchr(p + 1, '}');
+      if(end){
+        gsize len = end - (p + 1);
+        MediaTitleField field = media_title_format_field_from_name(p + 1, len);
+
+        if(field != MEDIA_TITLE_FIELD_LAST){
+          MediaTitleOp op = { MEDIA_TITLE_OP_FIELD, field, 0 };
+          g_array_append_val(self->ops, op);
+          self->fields |= MEDIA_TITLE_FIELD_MASK(field);
+          p = end + 1;
+          continue;
+        }
+
+        g_warning("Unknown title-format field '%.*s'", (gint)len, p + 1);
+        media_title_format_add_literal(self, p, end + 1 - p);
+        p = end + 1;
+        continue;
+      }
+    }
+
+    const gchar* next = p + 1;
+    while(*next && *next != '{' && *next != '}') next++;
+    media_title_format_add_literal(self, p, next - p);
+    p = next;
+  }
+
+  g_debug("title-format '%s' compiled to %u ops", format, self->ops->len);
+  return self;
+}
+
+void
+media_title_format_free(MediaTitleFormat* self){
+  if(!self) return;
+
+  g_array_unref(self->ops);
+  g_string_free(self->literals, TRUE);
+  g_free(self);
+}
+
+// Mask of the MediaTitleField values the template shows
+guint
+media_title_format_get_fields(const MediaTitleFormat* self){
+  return self->fields;
+}
+
+// Trimmed span of a borrowed string, nothing is copied
+const gchar*
+media_title_format_trim(const gchar* str, gsize* len){
+  *len = 0;
+  if(!str) return NULL;
+
+  while(g_ascii_isspace(*str)) str++;
+
+  gsize l = strlen(str);
+  while(l > 0 && g_ascii_isspace(str[l-1])) l--;
+
+  *len = l;
+  return str;
+}
+
+static gboolean
+media_title_format_field_empty(const MediaTitleOp* op, const gchar* const values[MEDIA_TITLE_FIELD_LAST]){
+  gsize len;
+  media_title_format_trim(values[op->offset], &len);
+  return len == 0;
+}
+
+/*
+ * Renders into out, which is truncated first. A literal is left out when
+ * the field right before or right after it is empty, so separators never
+ * dangle. Returns FALSE when every field used by the template is empty.
+ */
+gboolean
+media_title_format_render(const MediaTitleFormat* self,
+                          const gchar* const values[MEDIA_TITLE_FIELD_LAST],
+                          GString* out,
+                          MediaTitleSpan spans[MEDIA_TITLE_FIELD_LAST]){
+  gboolean any = FALSE;
+
+  g_string_truncate(out, 0);
+  if(spans) memset(spans, 0, sizeof(MediaTitleSpan) * MEDIA_TITLE_FIELD_LAST);
+
+  for(guint i = 0; i < self->ops->len; i++){
+    const MediaTitleOp* op = &g_array_index(self->ops, MediaTitleOp, i);
+
+    if(op->kind == MEDIA_TITLE_OP_FIELD){
+      gsize len;
+      const gchar* value = media_title_format_trim(values[op->offset], &len);
+
+      if(spans) spans[op->offset].start = out->len;
+      g_string_append_len(out, value, len);
+      if(spans) spans[op->offset].end = out->len;
+
+      any |= len > 0;
+      continue;
+    }
+
+    if(i > 0){
+      const MediaTitleOp* prev = &g_array_index(self->ops, MediaTitleOp, i - 1);
+      if(prev->kind == MEDIA_TITLE_OP_FIELD && media_title_format_field_empty(prev, values)) continue;
+    }
+
+    if(i + 1 < self->ops->len){
+      const MediaTitleOp* next = &g_array_index(self->ops, MediaTitleOp, i + 1);
+      if(next->kind == MEDIA_TITLE_OP_FIELD && media_title_format_field_empty(next, values)) continue;
+    }
+
+    g_string_append_len(out, self->literals->str + op->offset, op->length);
+  }
+
+  return any;
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+#define MEDIA_TITLE_FORMAT_DEFAULT "{artist} - {title}"
+
+typedef enum _MediaTitleField
+{
+  MEDIA_TITLE_FIELD_ARTIST,
+  MEDIA_TITLE_FIELD_TITLE,
+  MEDIA_TITLE_FIELD_ALBUM,
+  MEDIA_TITLE_FIELD_TRACK,
+  MEDIA_TITLE_FIELD_PLAYER,
+  MEDIA_TITLE_FIELD_LAST
+} MediaTitleField;
+
+#define MEDIA_TITLE_FIELD_MASK(field) (1u << (field))
+
+// Byte range of a rendered field, start == end when it was left out
+typedef struct _MediaTitleSpan
+{
+  gsize start;
+  gsize end;
+} MediaTitleSpan;
+
+typedef struct _MediaTitleFormat MediaTitleFormat;
+
+MediaTitleFormat* media_title_format_compile(const gchar* format);
+void media_title_format_free(MediaTitleFormat* self);
+
+guint media_title_format_get_fields(const MediaTitleFormat* self);
+
+gboolean media_title_format_render(const MediaTitleFormat* self,
+                                   const gchar* const values[MEDIA_TITLE_FIELD_LAST],
+                                   GString* out,
+                                   MediaTitleSpan spans[MEDIA_TITLE_FIELD_LAST]);
+
+const gchar* media_title_format_trim(const gchar* str, gsize* len);
+MediaTitleField media_title_format_field_from_name(const gchar* name, gsize len);
+
+G_END_DECLS
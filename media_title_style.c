@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "media_title_style.h"
+
+struct _MediaTitleStyle
+{
+  // Parsed style-<field> attributes, NULL for unstyled fields
+  PangoAttrList* field_attrs[MEDIA_TITLE_FIELD_LAST];
+  // Last built list and the spans it was built for
+  PangoAttrList* attrs;
+  MediaTitleSpan spans[MEDIA_TITLE_FIELD_LAST];
+};
+
+/*
+ * Styles are the attributes of a Pango <span> element, e.g.
+ * weight='bold' foreground='#e0af68'.
+ */
+MediaTitleStyle*
+media_title_style_new(gchar* const styles[MEDIA_TITLE_FIELD_LAST]){
+  MediaTitleStyle* self = NULL;
+
+  for(guint i = 0; i < MEDIA_TITLE_FIELD_LAST; i++){
+    if(!styles[i] || !styles[i][0]) continue;
+
+    gchar* markup = g_strdup_printf("<span %s>x</span>", styles[i]);
+    PangoAttrList* attrs = NULL;
+    GError* err = NULL;
+
+    if(pango_parse_markup(markup, -1, 0, &attrs, NULL, NULL, &err)){
+      if(!self) self = g_new0(MediaTitleStyle, 1);
+      self->field_attrs[i] = attrs;
+    } else {
+      g_warning("Invalid title style '%s': %s", styles[i], err->message);
+      g_error_free(err);
+    }
+
+    g_free(markup);
+  }
+
+  return self;
+}
+
+void
+media_title_style_free(MediaTitleStyle* self){
+  if(!self) return;
+
+  for(guint i = 0; i < MEDIA_TITLE_FIELD_LAST; i++){
+    g_clear_pointer(&self->field_attrs[i], pango_attr_list_unref);
+  }
+  g_clear_pointer(&self->attrs, pango_attr_list_unref);
+  g_free(self);
+}
+
+PangoAttrList*
+media_title_style_build(const MediaTitleStyle* self, const MediaTitleSpan spans[MEDIA_TITLE_FIELD_LAST]){
+  PangoAttrList* attrs = pango_attr_list_new();
+
+  for(guint i = 0; i < MEDIA_TITLE_FIELD_LAST; i++){
+    const MediaTitleSpan* span = &spans[i];
+    if(!self->field_attrs[i] || span->start == span->end) continue;
+
+    GSList* list = pango_attr_list_get_attributes(self->field_attrs[i]);
+    for(GSList* item = list; item; item = item->next){
+      PangoAttribute* attr = item->data;
+      attr->start_index = span->start;
+      attr->end_index = span->end;
+      pango_attr_list_insert(attrs, attr);
+    }
+    g_slist_free(list);
+  }
+
+  return attrs;
+}
+
+PangoAttrList*
+media_title_style_get_attrs(MediaTitleStyle* self, const MediaTitleSpan spans[MEDIA_TITLE_FIELD_LAST],
+                            gboolean* changed){
+  if(self->attrs && memcmp(self->spans, spans, sizeof(self->spans)) == 0){
+    if(changed) *changed = FALSE;
+    return self->attrs;
+  }
+
+  g_clear_pointer(&self->attrs, pango_attr_list_unref);
+  self->attrs = media_title_style_build(self, spans);
+  memcpy(self->spans, spans, sizeof(self->spans));
+
+  if(changed) *changed = TRUE;
+  return self->attrs;
+}
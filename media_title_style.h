@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <glib.h>
+#include <pango/pango.h>
+
+#include "media_title_format.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Per field styles of the title. The styles are parsed once, the attribute
+ * list for a rendered title is kept and only rebuilt when a span moved, so
+ * a new track with fields of the same lengths costs nothing here.
+ */
+typedef struct _MediaTitleStyle MediaTitleStyle;
+
+// NULL when no style is set or none parses
+MediaTitleStyle* media_title_style_new(gchar* const styles[MEDIA_TITLE_FIELD_LAST]);
+void media_title_style_free(MediaTitleStyle* self);
+
+// New list with the styles laid over spans
+PangoAttrList* media_title_style_build(const MediaTitleStyle* self,
+                                       const MediaTitleSpan spans[MEDIA_TITLE_FIELD_LAST]);
+// Cached list for spans, owned by self. changed is set when it was rebuilt.
+PangoAttrList* media_title_style_get_attrs(MediaTitleStyle* self,
+                                           const MediaTitleSpan spans[MEDIA_TITLE_FIELD_LAST],
+                                           gboolean* changed);
+
+G_END_DECLS
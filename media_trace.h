@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+#define MEDIA_TRACE_GROUP "waybar-mediaplayer"
+
+#ifdef WAYBAR_MEDIAPLAYER_TRACING
+
+#include <sysprof-capture.h>
+
+typedef struct _MediaTraceScope
+{
+  gint64 begin;
+  const gchar* name;
+  const gchar* detail;
+} MediaTraceScope;
+
+static inline void
+media_trace_scope_end(MediaTraceScope* scope){
+  sysprof_collector_mark(scope->begin, SYSPROF_CAPTURE_CURRENT_TIME - scope->begin,
+                         MEDIA_TRACE_GROUP, scope->name, scope->detail);
+}
+
+/*
+ * Marks the rest of the enclosing block, whatever way it is left. The
+ * detail string (usually the player bus name) must outlive the block.
+ */
+#define MEDIA_TRACE_SCOPE(name, detail) \
+  __attribute__((cleanup(media_trace_scope_end))) \
+  MediaTraceScope G_PASTE(media_trace_scope_, __LINE__) = { SYSPROF_CAPTURE_CURRENT_TIME, (name), (detail) }
+
+#else
+
+// Without -Dtracing=true the marks and their arguments compile to nothing
+#define MEDIA_TRACE_SCOPE(name, detail) (void)0
+
+#endif
+
+G_END_DECLS
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define G_LOG_DOMAIN "waybarmediaplayer.media-view-model"
+
+#include <glib.h>
+#include <string.h>
+
+#include "media_view_model.h"
+
+void
+media_view_model_init(MediaViewModel* self, const MediaTitleFormat* format){
+  memset(self, 0, sizeof(MediaViewModel));
+  self->title = g_string_sized_new(128);
+  self->format = format;
+
+  guint used = media_title_format_get_fields(format);
+  for(guint i = 0; i < MEDIA_TITLE_FIELD_LAST; i++){
+    if(used & MEDIA_TITLE_FIELD_MASK(i)) self->fields[i] = g_string_sized_new(64);
+  }
+}
+
+void
+media_view_model_clear(MediaViewModel* self){
+  if(self->title){
+    g_string_free(self->title, TRUE);
+    self->title = NULL;
+  }
+
+  for(guint i = 0; i < MEDIA_TITLE_FIELD_LAST; i++){
+    if(self->fields[i]){
+      g_string_free(self->fields[i], TRUE);
+      self->fields[i] = NULL;
+    }
+  }
+}
+
+/*
+ * Remembers the trimmed values of the template fields, returns TRUE when one
+ * of them differs from the last render.
+ */
+static gboolean
+media_view_model_fields_changed(MediaViewModel* self, const MediaViewInput* input){
+  gboolean changed = !self->title_rendered;
+
+  for(guint i = 0; i < MEDIA_TITLE_FIELD_LAST; i++){
+    if(!self->fields[i]) continue;
+
+    gsize len;
+    const gchar* value = media_title_format_trim(input->fields[i], &len);
+
+    if(self->fields[i]->len != len || (len > 0 && memcmp(self->fields[i]->str, value, len) != 0)){
+      g_string_truncate(self->fields[i], 0);
+      g_string_append_len(self->fields[i], value, len);
+      changed = TRUE;
+    }
+  }
+
+  return changed;
+}
+
+gdouble
+media_view_progress_fraction(gboolean has_progress, gint64 position, gint64 length){
+  if(!has_progress || length <= 0 || position <= 0) return 0.0;
+  if(position >= length) return 1.0;
+
+  return (gdouble)position / (gdouble)length;
+}
+
+/*
+ * Computes the display state for the input and returns the
+ * MediaViewChange mask of what differs from the previous one.
+ */
+guint
+media_view_model_update(MediaViewModel* self, const MediaViewInput* input){
+  guint changes = 0;
+
+  gboolean visible = input->player_count > 0;
+  if(visible != self->visible){
+    self->visible = visible;
+    changes |= MEDIA_VIEW_CHANGED_VISIBLE;
+  }
+
+  if(!visible) return changes;
+
+  gchar counter[sizeof(self->counter)];
+  g_snprintf(counter, sizeof(counter), "[%u/%u]", input->player_pos, input->player_count);
+  if(strcmp(counter, self->counter) != 0){
+    memcpy(self->counter, counter, sizeof(counter));
+    changes |= MEDIA_VIEW_CHANGED_COUNTER;
+  }
+
+  // Only a change of a field used by the template renders the title again
+  if(media_view_model_fields_changed(self, input)){
+    if(!media_title_format_render(self->format, input->fields, self->title, self->spans)){
+      g_string_assign(self->title, "No Media");
+      memset(self->spans, 0, sizeof(self->spans));
+    }
+    self->title_rendered = TRUE;
+    changes |= MEDIA_VIEW_CHANGED_TITLE;
+  }
+
+  if(input->playing != self->playing){
+    self->playing = input->playing;
+    changes |= MEDIA_VIEW_CHANGED_PLAYING;
+  }
+
+  if(input->can_go_previous != self->show_previous){
+    self->show_previous = input->can_go_previous;
+    changes |= MEDIA_VIEW_CHANGED_PREVIOUS;
+  }
+
+  if(input->can_go_next != self->show_next){
+    self->show_next = input->can_go_next;
+    changes |= MEDIA_VIEW_CHANGED_NEXT;
+  }
+
+  gdouble progress = media_view_progress_fraction(input->has_progress, input->position, input->length);
+  if(progress != self->progress){
+    self->progress = progress;
+    changes |= MEDIA_VIEW_CHANGED_PROGRESS;
+  }
+
+  return changes;
+}
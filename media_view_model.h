@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <glib.h>
+
+#include "media_title_format.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Player state as seen by the widget. Strings are borrowed and may carry
+ * surrounding whitespace.
+ */
+typedef struct _MediaViewInput
+{
+  guint player_pos;
+  guint player_count;
+
+  // Indexed by MediaTitleField, only the fields of the template are read
+  const gchar* fields[MEDIA_TITLE_FIELD_LAST];
+
+  gboolean playing;
+  // Playing or paused, the progress strip is hidden otherwise
+  gboolean has_progress;
+  gboolean can_go_previous;
+  gboolean can_go_next;
+
+  gint64 position;
+  gint64 length;
+} MediaViewInput;
+
+typedef enum _MediaViewChange
+{
+  MEDIA_VIEW_CHANGED_VISIBLE  = 1 << 0,
+  MEDIA_VIEW_CHANGED_COUNTER  = 1 << 1,
+  MEDIA_VIEW_CHANGED_TITLE    = 1 << 2,
+  MEDIA_VIEW_CHANGED_PLAYING  = 1 << 3,
+  MEDIA_VIEW_CHANGED_PREVIOUS = 1 << 4,
+  MEDIA_VIEW_CHANGED_NEXT     = 1 << 5,
+  MEDIA_VIEW_CHANGED_PROGRESS = 1 << 6,
+  MEDIA_VIEW_CHANGED_ALL      = (1 << 7) - 1,
+} MediaViewChange;
+
+/*
+ * What the widget displays. Holds no GTK state, so it can be driven and
+ * compared without a display.
+ */
+typedef struct _MediaViewModel
+{
+  gboolean visible;
+  gchar counter[32];
+  GString* title;
+  MediaTitleSpan spans[MEDIA_TITLE_FIELD_LAST];
+
+  const MediaTitleFormat* format;
+  // Trimmed field values the title was last rendered from
+  GString* fields[MEDIA_TITLE_FIELD_LAST];
+  gboolean title_rendered;
+
+  gboolean playing;
+  gboolean show_previous;
+  gboolean show_next;
+
+  gdouble progress;
+} MediaViewModel;
+
+void media_view_model_init(MediaViewModel* self, const MediaTitleFormat* format);
+void media_view_model_clear(MediaViewModel* self);
+
+guint media_view_model_update(MediaViewModel* self, const MediaViewInput* input);
+
+gdouble media_view_progress_fraction(gboolean has_progress, gint64 position, gint64 length);
+
+G_END_DECLS
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define G_LOG_DOMAIN "waybarmediaplayer.media-watchdog"
+
+#include <glib.h>
+
+#include "media_watchdog.h"
+
+gint64 media_watchdog_threshold = 0;
+
+static guint64 histogram[MEDIA_WATCHDOG_BUCKETS] = {0, };
+static guint64 stalls = 0;
+static gint64 worst = 0;
+static const gchar* worst_name = NULL;
+
+void
+media_watchdog_set_threshold(guint threshold_ms){
+  media_watchdog_threshold = (gint64)threshold_ms * 1000;
+
+  if(media_watchdog_threshold)
+    g_info("Watchdog enabled, reporting callbacks over %u ms", threshold_ms);
+}
+
+void
+media_watchdog_scope_end(MediaWatchdogScope* scope){
+  // Scopes opened while the watchdog was off have no start time
+  if(!media_watchdog_threshold || !scope->begin) return;
+
+  gint64 duration = g_get_monotonic_time() - scope->begin;
+
+  guint bucket = duration > 0 ? g_bit_storage(duration) - 1 : 0;
+  histogram[MIN(bucket, MEDIA_WATCHDOG_BUCKETS - 1)]++;
+
+  if(duration > worst){
+    worst = duration;
+    worst_name = scope->name;
+  }
+
+  if(duration >= media_watchdog_threshold){
+    stalls++;
+    g_warning("%s blocked the main loop for %.1f ms (%s)", scope->name,
+              duration / 1000.0, scope->detail ? scope->detail : "no player");
+  }
+}
+
+void
+media_watchdog_append(GString* out){
+  if(!media_watchdog_threshold) return;
+
+  g_string_append_printf(out, "watchdog-stalls: %" G_GUINT64_FORMAT "\n", stalls);
+  g_string_append_printf(out, "watchdog-worst: %.1f ms (%s)\n", worst / 1000.0,
+                         worst_name ? worst_name : "none");
+
+  for(guint i = 0; i < MEDIA_WATCHDOG_BUCKETS; i++){
+    if(!histogram[i]) continue;
+    g_string_append_printf(out, "watchdog-us[%" G_GUINT64_FORMAT "]: %" G_GUINT64_FORMAT "\n",
+                           (guint64)1 << i, histogram[i]);
+  }
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+// Callbacks are bucketed by duration, bucket n holds [2^n, 2^(n+1)) us
+#define MEDIA_WATCHDOG_BUCKETS 24
+
+typedef struct _MediaWatchdogScope
+{
+  gint64 begin;
+  const gchar* name;
+  const gchar* detail;
+} MediaWatchdogScope;
+
+// Threshold in microseconds, 0 while the watchdog is off
+extern gint64 media_watchdog_threshold;
+
+void media_watchdog_set_threshold(guint threshold_ms);
+void media_watchdog_scope_end(MediaWatchdogScope* scope);
+void media_watchdog_append(GString* out);
+
+/*
+ * Measures the rest of the enclosing callback. The detail string (usually
+ * the player bus name) must outlive the block. Costs a single branch while
+ * the watchdog is off.
+ */
+#define MEDIA_WATCHDOG_SCOPE(name, detail) \
+  __attribute__((cleanup(media_watchdog_scope_end))) \
+  MediaWatchdogScope G_PASTE(media_watchdog_scope_, __LINE__) = \
+    { media_watchdog_threshold ? g_get_monotonic_time() : 0, (name), (detail) }
+
+G_END_DECLS
@@ -20,6 +20,8 @@
 
 #include "mpris_media_player.h"
 #include "mpris_media_manager.h"
+#include "media_watchdog.h"
+#include "media_timeline.h"
 
 struct _GMprisMediaManager
 {
@@ -30,6 +32,12 @@ struct _GMprisMediaManager
   guint name_owner_sub_id;
 
   GList* media_players;
+
+  gboolean ready;
+  guint pending_players;
+  gint64 start_time;
+
+  MprisReplayer* replayer;
 };
 
 struct _GMprisMediaManagerClass
@@ -40,6 +48,7 @@ struct _GMprisMediaManagerClass
 enum
 {
   G_MPRIS_MEDIA_MANAGER_PROP_0,
+  G_MPRIS_MEDIA_MANAGER_PROP_CONNECTION,
   G_MPRIS_MEDIA_MANAGER_PROP_LAST
 };
 
@@ -48,6 +57,7 @@ enum
   G_MPRIS_MEDIA_MANAGER_SIGNAL_0,
   G_MPRIS_MEDIA_MANAGER_SIGNAL_PLAYER_ADDED,
   G_MPRIS_MEDIA_MANAGER_SIGNAL_PLAYER_REMOVED,
+  G_MPRIS_MEDIA_MANAGER_SIGNAL_READY,
   G_MPRIS_MEDIA_MANAGER_SIGNAL_LAST
 };
 
@@ -64,12 +74,11 @@ g_mpris_media_manager_get_property(GObject * object,
     guint prop_id, GValue * value, GParamSpec * pspec)
 {
   GMprisMediaManager *self = G_MPRIS_MEDIA_MANAGER(object);
-  (void)self;
 
   switch (prop_id) {
-//    case GTK_MEDIA_CONTROLLER_PROP_STATE:
-//      g_value_set_enum(value, self->state);
-//      break;
+    case G_MPRIS_MEDIA_MANAGER_PROP_CONNECTION:
+      g_value_set_object(value, self->conn);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -107,6 +116,11 @@ g_mpris_media_manager_finalize(GObject * object)
   GMprisMediaManager *self = G_MPRIS_MEDIA_MANAGER(object);
 
   if (self->media_players) {
+    // Players still waiting on a reply outlive the manager
+    for (GList* l = self->media_players; l; l = l->next) {
+      g_signal_handlers_disconnect_by_data(l->data, self);
+      g_object_run_dispose(G_OBJECT(l->data));
+    }
     g_list_free_full(self->media_players, g_object_unref);
     self->media_players = NULL;
   }
@@ -116,8 +130,10 @@ g_mpris_media_manager_finalize(GObject * object)
     self->name_owner_sub_id = 0;
   }
 
-  g_object_unref(self->conn);
-  self->conn = NULL;
+  // Replayed sessions never open a connection
+  g_clear_object(&self->conn);
+
+  g_clear_pointer(&self->replayer, mpris_replayer_free);
 
   G_OBJECT_CLASS
       (g_mpris_media_manager_parent_class)->finalize(object);
@@ -144,6 +160,13 @@ g_mpris_media_manager_class_init(GMprisMediaManagerClass * klass)
   gobject_class->finalize = g_mpris_media_manager_finalize;
   gobject_class->constructed = g_mpris_media_manager_constructed;
 
+  g_mpris_media_manager_param_specs[G_MPRIS_MEDIA_MANAGER_PROP_CONNECTION] =
+    g_param_spec_object("connection",
+                        "Connection",
+                        "GDBusConnection players are watched on",
+                        G_TYPE_DBUS_CONNECTION,
+                        G_PARAM_READABLE);
+
   g_mpris_media_manager_signals[G_MPRIS_MEDIA_MANAGER_SIGNAL_PLAYER_ADDED] =
     g_signal_new("player-added",
                   G_TYPE_FROM_CLASS(gobject_class),
@@ -168,6 +191,17 @@ g_mpris_media_manager_class_init(GMprisMediaManagerClass * klass)
                   1,
                   G_TYPE_MPRIS_MEDIA_PLAYER);
 
+  g_mpris_media_manager_signals[G_MPRIS_MEDIA_MANAGER_SIGNAL_READY] =
+    g_signal_new("ready",
+                  G_TYPE_FROM_CLASS(gobject_class),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  0,
+                  NULL,
+                  NULL,
+                  NULL,
+                  G_TYPE_NONE,
+                  0);
+
   g_object_class_install_properties (gobject_class,
       G_MPRIS_MEDIA_MANAGER_PROP_LAST, g_mpris_media_manager_param_specs);
 }
@@ -186,6 +220,24 @@ g_mpris_media_manager_new(){
   self->conn = NULL;
   self->name_owner_sub_id = 0;
   self->media_players = NULL;
+  self->ready = FALSE;
+  self->pending_players = 0;
+  self->start_time = 0;
+  self->replayer = NULL;
+
+  return self;
+}
+
+/*
+ * Watches players on the given connection instead of the session bus, so a
+ * private bus (e.g. GTestDBus) can drive the manager without a desktop.
+ */
+GMprisMediaManager*
+g_mpris_media_manager_new_for_connection(GDBusConnection* conn){
+  g_return_val_if_fail(G_IS_DBUS_CONNECTION(conn), NULL);
+
+  GMprisMediaManager* self = g_mpris_media_manager_new();
+  self->conn = g_object_ref(conn);
 
   return self;
 }
@@ -194,18 +246,44 @@ static gboolean is_mpris_name(const char *name) {
   return name && g_str_has_prefix(name, MPRIS_PREFIX);
 }
 
-static void 
+static void
+mpris_media_manager_set_ready(GMprisMediaManager* self){
+  if(self->ready) return;
+
+  self->ready = TRUE;
+  media_timeline_mark(MEDIA_TIMELINE_PLAYERS_READY);
+  g_info("%u mpris players initialized in %.1f ms", g_list_length(self->media_players),
+         (g_get_monotonic_time() - self->start_time) / 1000.0);
+
+  g_signal_emit(self, g_mpris_media_manager_signals[G_MPRIS_MEDIA_MANAGER_SIGNAL_READY], 0);
+}
+
+static void
+on_initial_player_ready(GMprisMediaPlayer* player, gpointer user_data){
+  GMprisMediaManager *self = G_MPRIS_MEDIA_MANAGER(user_data);
+
+  g_signal_handlers_disconnect_by_func(player, on_initial_player_ready, self);
+  media_timeline_mark_player(g_mpris_media_player_get_bus_name(player));
+
+  if(self->pending_players > 0 && --self->pending_players == 0){
+    mpris_media_manager_set_ready(self);
+  }
+}
+
+static GMprisMediaPlayer*
 mpris_media_manager_add_player(GMprisMediaManager* self, const char* iface){
-  g_return_if_fail(G_IS_MPRIS_MEDIA_MANAGER(self));
+  g_return_val_if_fail(G_IS_MPRIS_MEDIA_MANAGER(self), NULL);
 
   if(!is_mpris_name(iface)){
-    return;
+    return NULL;
   }
 
   GMprisMediaPlayer* player = g_mpris_media_player_new(self->conn, iface);
   self->media_players = g_list_append(self->media_players, player);
 
   g_signal_emit(self, g_mpris_media_manager_signals[G_MPRIS_MEDIA_MANAGER_SIGNAL_PLAYER_ADDED], 0, player);
+
+  return player;
 }
 
 static void 
@@ -223,10 +301,15 @@ mpris_media_manager_remove_player(GMprisMediaManager* self, const char* iface){
 
       if(g_mpris_media_player_is_iface(player, iface)){
 
+        // A player leaving before its first reply must not hold back startup
+        if(g_signal_handlers_disconnect_by_func(player, on_initial_player_ready, self) > 0){
+          on_initial_player_ready(player, self);
+        }
+
         g_signal_emit(self, g_mpris_media_manager_signals[G_MPRIS_MEDIA_MANAGER_SIGNAL_PLAYER_REMOVED], 0, player);
 
-        self->media_players = g_list_remove_link(self->media_players, item);
-        g_list_free_full(item, g_object_unref);
+        self->media_players = g_list_remove_link(self->media_players, next);
+        g_list_free_full(next, g_object_unref);
         break;
       }
     }
@@ -248,6 +331,9 @@ on_name_owner_changed(GDBusConnection *c,
   g_debug("on_name_owner_changed entered");
 
   GMprisMediaManager *self = G_MPRIS_MEDIA_MANAGER(user_data);
+  MEDIA_WATCHDOG_SCOPE("on_name_owner_changed", NULL);
+
+  mpris_recorder_record(MPRIS_RECORD_SIGNAL, DBUS_NAME, IFACE_DBUS, "NameOwnerChanged", parameters);
 
   const char *name = NULL;
   const char *old_owner = NULL;
@@ -268,56 +354,135 @@ on_name_owner_changed(GDBusConnection *c,
 }
 
 
-static void collect_all_players(GMprisMediaManager *self) {
+static void mpris_media_manager_add_listed_players(GMprisMediaManager *self, GVariant *ret);
+
+static void
+on_list_names_complete(GObject *source_object,
+                       GAsyncResult *result,
+                       gpointer user_data) {
+  GMprisMediaManager *self = G_MPRIS_MEDIA_MANAGER(user_data);
+  MEDIA_WATCHDOG_SCOPE("on_list_names_complete", NULL);
   GError *err = NULL;
 
-  GVariant *ret = g_dbus_connection_call_sync(
-      self->conn,
-      DBUS_NAME,
-      DBUS_PATH,
-      IFACE_DBUS,
-      "ListNames",
-      NULL,
-      G_VARIANT_TYPE("(as)"),
-      G_DBUS_CALL_FLAGS_NONE,
-      -1,
-      NULL,
-      &err);
+  GVariant *ret = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source_object), result, &err);
 
   if (!ret) {
     g_critical("ListNames failed: %s\n", err ? err->message : "unknown");
     g_clear_error(&err);
+    mpris_media_manager_set_ready(self);
+    g_object_unref(self);
     return;
   }
 
+  mpris_recorder_record(MPRIS_RECORD_REPLY, DBUS_NAME, IFACE_DBUS, "ListNames", ret);
+  mpris_media_manager_add_listed_players(self, ret);
+
+  g_variant_unref(ret);
+  g_object_unref(self);
+}
+
+static void
+mpris_media_manager_add_listed_players(GMprisMediaManager *self, GVariant *ret) {
+  media_timeline_mark(MEDIA_TIMELINE_LIST_NAMES);
+
   GVariantIter *iter = NULL;
   g_variant_get(ret, "(as)", &iter);
 
+  // Every player starts its own property requests, they all travel the
+  // bus together and the manager is ready once the last reply is in
   const char *name = NULL;
   while (g_variant_iter_next(iter, "&s", &name)) {
     if (is_mpris_name(name)) {
       g_info("new mpris player found: %s", name);
-      mpris_media_manager_add_player(self, name);
+      GMprisMediaPlayer* player = mpris_media_manager_add_player(self, name);
+      if (player) {
+        self->pending_players++;
+        g_signal_connect(player, "ready", G_CALLBACK(on_initial_player_ready), self);
+      }
     }
   }
 
   g_variant_iter_free(iter);
-  g_variant_unref(ret);
+
+  if (self->pending_players == 0) {
+    mpris_media_manager_set_ready(self);
+  }
+}
+
+static void collect_all_players(GMprisMediaManager *self) {
+  g_dbus_connection_call(
+      self->conn,
+      DBUS_NAME,
+      DBUS_PATH,
+      IFACE_DBUS,
+      "ListNames",
+      NULL,
+      G_VARIANT_TYPE("(as)"),
+      G_DBUS_CALL_FLAGS_NONE,
+      DBUS_CALL_TIMEOUT_MS,
+      NULL,
+      on_list_names_complete,
+      g_object_ref(self));
+}
+
+/*
+ * Feeds a recorded message to the manager or to the player it was sent by,
+ * through the same handlers the live bus traffic goes through.
+ */
+static void
+on_replay_dispatch(gpointer target, MprisRecordKind kind, const gchar* bus_name,
+                   const gchar* iface, const gchar* member, GVariant* body){
+  GMprisMediaManager *self = G_MPRIS_MEDIA_MANAGER(target);
+
+  if(g_strcmp0(bus_name, DBUS_NAME) == 0){
+    if(kind == MPRIS_RECORD_SIGNAL && g_strcmp0(member, "NameOwnerChanged") == 0 &&
+       g_variant_is_of_type(body, G_VARIANT_TYPE("(sss)"))){
+      on_name_owner_changed(NULL, bus_name, DBUS_PATH, iface, member, body, self);
+    } else if(kind == MPRIS_RECORD_REPLY && g_strcmp0(member, "ListNames") == 0 &&
+              g_variant_is_of_type(body, G_VARIANT_TYPE("(as)"))){
+      mpris_media_manager_add_listed_players(self, body);
+    }
+    return;
+  }
+
+  for(GList* l = self->media_players; l; l = l->next){
+    GMprisMediaPlayer* player = l->data;
+    if(g_mpris_media_player_is_iface(player, bus_name)){
+      g_mpris_media_player_replay(player, kind, iface, member, body);
+      return;
+    }
+  }
 }
 
 void
 g_mpris_media_manager_start(GMprisMediaManager* self){
   g_return_if_fail(G_IS_MPRIS_MEDIA_MANAGER(self));
 
+  self->start_time = g_get_monotonic_time();
+
+  if(!self->conn && !self->replayer){
+    self->replayer = mpris_replayer_new_from_env();
+    if(self->replayer){
+      // Players are created without a connection and never touch the bus
+      mpris_replayer_start(self->replayer, on_replay_dispatch, self);
+      return;
+    }
+  }
+
   if(!self->conn){
     GError *err = NULL;
     self->conn = g_bus_get_sync(G_BUS_TYPE_SESSION, NULL, &err);
     if (!self->conn) {
       g_critical("failed to connect to session bus: %s", err ? err->message : "unknown");
       g_clear_error(&err);
+      mpris_media_manager_set_ready(self);
       return;
     }
+  }
+
+  media_timeline_mark(MEDIA_TIMELINE_BUS);
 
+  if(!self->name_owner_sub_id){
     self->name_owner_sub_id = g_dbus_connection_signal_subscribe(
       self->conn,
       DBUS_NAME,
@@ -26,6 +26,7 @@
 #define IFACE_DBUS        "org.freedesktop.DBus"
 #define DBUS_NAME         "org.freedesktop.DBus"
 #define DBUS_PATH         "/org/freedesktop/DBus"
+#define DBUS_CALL_TIMEOUT_MS 2000
 
 G_BEGIN_DECLS
 
@@ -45,6 +46,7 @@ typedef struct _GMprisMediaManagerClass
 
 GType g_mpris_media_manager_get_type(void);
 GMprisMediaManager* g_mpris_media_manager_new();
+GMprisMediaManager* g_mpris_media_manager_new_for_connection(GDBusConnection* conn);
 
 void g_mpris_media_manager_start(GMprisMediaManager* self);
 
@@ -17,11 +17,26 @@
 
 #define G_LOG_DOMAIN "waybarmediaplayer.media-player"
 
+#include <math.h>
 #include <glib.h>
 #include <gio/gio.h>
 #include <glib-object.h>
+#include <string.h>
 
 #include "mpris_media_player.h"
+#include "mpris_track_list.h"
+#include "media_stats.h"
+#include "media_trace.h"
+#include "media_watchdog.h"
+
+/*
+ * Watchdog scope for D-Bus reply callbacks. They drop the reference their
+ * call held, possibly the last one, so the player is kept until the scope
+ * has reported its name.
+ */
+#define MPRIS_REPLY_SCOPE(name, player) \
+  g_autoptr(GObject) G_PASTE(reply_guard_, __LINE__) = g_object_ref(G_OBJECT(player)); \
+  MEDIA_WATCHDOG_SCOPE((name), (player)->iface)
 
 struct _GMprisMediaPlayer
 {
@@ -29,14 +44,53 @@ struct _GMprisMediaPlayer
   GDBusConnection *conn;
   const char* iface;
 
-  GDBusProxy *player_proxy;
+  GHashTable *player_props;
   guint props_sub_id;
   guint seeked_sub_id;
 
+  guint pending_init;
+  gboolean initialized;
+  GCancellable *init_cancellable;
+
+  gchar *identity;
+  gchar *desktop_entry;
+  gboolean can_raise;
+  gboolean has_track_list;
+
+  guint call_failures;
+  gboolean circuit_open;
+  guint circuit_backoff;
+  guint circuit_probe_id;
+
+  gdouble event_tokens;
+  gint64 event_refill_time;
+  guint deferred_update_id;
+  gboolean deferred_update_info;
+  guint64 signals_received;
+  guint64 events_received;
+  guint64 events_deferred;
+  gint64 event_window_start;
+  guint event_window_deferred;
+  guint throttled_windows;
+  gboolean quarantined;
+
+  GQueue *pending_commands;
+  // Last command sent, repeats inside MPRIS_COMMAND_COLLAPSE_MS are dropped
+  // even once it has left the queue
+  const gchar *last_command;
+  gint64 last_command_time;
+  GMprisMediaPlayerState confirmed_state;
+  guint command_confirm_id;
+
   GMprisMediaPlayerState state;
   gchar *title;
   gchar *artist;
+  gchar *album;
+  // GMprisMediaPlayerField mask of the metadata kept
+  guint fields;
+  gint track_number;
   gchar *arturl;
+  gchar *track_id;
 
   gint64 last_known_position;
   gint64 position;
@@ -46,6 +100,29 @@ struct _GMprisMediaPlayer
   gboolean can_go_previous;
   gboolean can_play;
   gboolean can_control;
+  gboolean can_seek;
+  gdouble volume;
+
+  // Volume write throttling, the same scheme as the seeks
+  guint volume_source_id;
+  gboolean volume_in_flight;
+  gboolean volume_queued;
+  gdouble volume_target;
+  // The player reported a Volume since the last write was sent
+  gboolean volume_reported;
+  guint64 volume_writes;
+  guint64 volume_collapsed;
+
+  // Seek throttling, seek_base is where the player was at seek_base_time
+  // for the relative Seek fallback
+  guint seek_source_id;
+  gboolean seek_in_flight;
+  gboolean seek_queued;
+  gint64 seek_target;
+  gint64 seek_base;
+  gint64 seek_base_time;
+  guint64 seeks_sent;
+  guint64 seeks_collapsed;
 
   guint position_timer_id;
   GTimer *position_timer;
@@ -58,6 +135,22 @@ struct _GMprisMediaPlayerClass
   GObjectClass parent_class;
 };
 
+/*
+ * A command sent to the player. State commands are shown right away and
+ * stay queued until the player confirms the expected state, fails, or
+ * does not confirm within MPRIS_COMMAND_CONFIRM_MS of its reply.
+ */
+typedef struct _MprisPendingCommand
+{
+  GMprisMediaPlayer *player;
+  const gchar *method;
+  GMprisMediaPlayerState expected_state;
+  gboolean has_expected_state;
+  gboolean replied;
+  gint64 issued_time;
+  GCancellable *cancellable;
+} MprisPendingCommand;
+
 enum
 {
   G_MPRIS_MEDIA_PLAYER_PROP_0,
@@ -67,12 +160,20 @@ enum
   G_MPRIS_MEDIA_PLAYER_PROP_ARTIST,
   G_MPRIS_MEDIA_PLAYER_PROP_ARTURL,
   G_MPRIS_MEDIA_PLAYER_PROP_TITLE,
+  G_MPRIS_MEDIA_PLAYER_PROP_ALBUM,
+  G_MPRIS_MEDIA_PLAYER_PROP_TRACK_NUMBER,
   G_MPRIS_MEDIA_PLAYER_PROP_POSITION,
   G_MPRIS_MEDIA_PLAYER_PROP_LENGTH,
   G_MPRIS_MEDIA_PLAYER_PROP_CAN_GO_NEXT,
   G_MPRIS_MEDIA_PLAYER_PROP_CAN_GO_PREVIOUS,
   G_MPRIS_MEDIA_PLAYER_PROP_CAN_PLAY,
   G_MPRIS_MEDIA_PLAYER_PROP_CAN_CONTROL,
+  G_MPRIS_MEDIA_PLAYER_PROP_IDENTITY,
+  G_MPRIS_MEDIA_PLAYER_PROP_DESKTOP_ENTRY,
+  G_MPRIS_MEDIA_PLAYER_PROP_CAN_RAISE,
+  G_MPRIS_MEDIA_PLAYER_PROP_HAS_TRACK_LIST,
+  G_MPRIS_MEDIA_PLAYER_PROP_VOLUME,
+  G_MPRIS_MEDIA_PLAYER_PROP_QUARANTINED,
   G_MPRIS_MEDIA_PLAYER_PROP_LAST
 };
 
@@ -82,6 +183,7 @@ enum
   G_MPRIS_MEDIA_PLAYER_SIGNAL_PROPERTY_CHANGED,
   G_MPRIS_MEDIA_PLAYER_SIGNAL_STATE_CHANGED,
   G_MPRIS_MEDIA_PLAYER_SIGNAL_META_CHANGED,
+  G_MPRIS_MEDIA_PLAYER_SIGNAL_READY,
   G_MPRIS_MEDIA_PLAYER_SIGNAL_LAST
 };
 
@@ -136,6 +238,12 @@ g_mpris_media_player_get_property(GObject * object,
     case G_MPRIS_MEDIA_PLAYER_PROP_ARTURL:
       g_value_set_string(value, self->arturl);
       break;
+    case G_MPRIS_MEDIA_PLAYER_PROP_ALBUM:
+      g_value_set_string(value, self->album);
+      break;
+    case G_MPRIS_MEDIA_PLAYER_PROP_TRACK_NUMBER:
+      g_value_set_int(value, self->track_number);
+      break;
     case G_MPRIS_MEDIA_PLAYER_PROP_POSITION:
       g_value_set_int64(value, self->position);
       break;
@@ -154,6 +262,24 @@ g_mpris_media_player_get_property(GObject * object,
     case G_MPRIS_MEDIA_PLAYER_PROP_CAN_CONTROL:
       g_value_set_boolean(value, self->can_control);
       break;
+    case G_MPRIS_MEDIA_PLAYER_PROP_IDENTITY:
+      g_value_set_string(value, self->identity);
+      break;
+    case G_MPRIS_MEDIA_PLAYER_PROP_DESKTOP_ENTRY:
+      g_value_set_string(value, self->desktop_entry);
+      break;
+    case G_MPRIS_MEDIA_PLAYER_PROP_CAN_RAISE:
+      g_value_set_boolean(value, self->can_raise);
+      break;
+    case G_MPRIS_MEDIA_PLAYER_PROP_HAS_TRACK_LIST:
+      g_value_set_boolean(value, self->has_track_list);
+      break;
+    case G_MPRIS_MEDIA_PLAYER_PROP_VOLUME:
+      g_value_set_double(value, self->volume);
+      break;
+    case G_MPRIS_MEDIA_PLAYER_PROP_QUARANTINED:
+      g_value_set_boolean(value, self->quarantined);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -185,13 +311,15 @@ static gboolean
 position_update_timer_callback(gpointer user_data)
 {
   GMprisMediaPlayer *self = G_MPRIS_MEDIA_PLAYER(user_data);
+  MEDIA_WATCHDOG_SCOPE("position_update_timer_callback", self->iface);
+
+  MEDIA_STATS_INC(MEDIA_STAT_TIMER_WAKEUPS);
   
   if (self->state != G_MPRIS_MEDIA_PLAYER_STATE_PLAYING) {
     return G_SOURCE_CONTINUE;
   }
   
-  gdouble elapsed_seconds = g_timer_elapsed(self->position_timer, NULL);
-  gint64 estimated_position = self->last_known_position + (gint64)(elapsed_seconds * 1000000);
+  gint64 estimated_position = g_mpris_media_player_get_position_estimate(self);
   
   if (llabs(estimated_position - self->position) > 100000) {
     self->position = estimated_position;
@@ -233,23 +361,147 @@ stop_position_timer(GMprisMediaPlayer *self)
 
 
 static void
-g_mpris_media_player_finalize(GObject * object)
+set_state(GMprisMediaPlayer *self, GMprisMediaPlayerState new_state)
 {
-  g_debug("g_mpris_media_player_finalize entered");
+  if (self->state == new_state) return;
 
-  GMprisMediaPlayer *self = G_MPRIS_MEDIA_PLAYER(object);
+  self->state = new_state;
+
+  if(self->state == G_MPRIS_MEDIA_PLAYER_STATE_PLAYING){
+    start_position_timer(self);
+  } else {
+    stop_position_timer(self);
+  }
+
+  g_object_notify_by_pspec(G_OBJECT(self), 
+        g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_STATE]);
+
+  g_signal_emit(self, 
+        g_mpris_media_player_signals[G_MPRIS_MEDIA_PLAYER_SIGNAL_STATE_CHANGED], 
+        0);
+}
+
+static void
+pending_command_free(MprisPendingCommand *cmd)
+{
+  g_clear_object(&cmd->cancellable);
+}
+
+static void
+pending_command_unref(gpointer data)
+{
+  g_rc_box_release_full(data, (GDestroyNotify)pending_command_free);
+}
+
+static void
+cancel_pending_commands(GMprisMediaPlayer *self)
+{
+  if (self->command_confirm_id) {
+    g_source_remove(self->command_confirm_id);
+    self->command_confirm_id = 0;
+  }
+
+  MprisPendingCommand *cmd;
+  while ((cmd = g_queue_pop_head(self->pending_commands)) != NULL) {
+    g_cancellable_cancel(cmd->cancellable);
+    pending_command_unref(cmd);
+  }
+}
+
+static MprisPendingCommand*
+last_state_command(GMprisMediaPlayer *self)
+{
+  for (GList *l = g_queue_peek_tail_link(self->pending_commands); l; l = l->prev) {
+    MprisPendingCommand *cmd = l->data;
+    if (cmd->has_expected_state) return cmd;
+  }
+  return NULL;
+}
+
+static void
+drop_state_commands(GMprisMediaPlayer *self, gboolean only_replied)
+{
+  GList *l = g_queue_peek_head_link(self->pending_commands);
+  while (l) {
+    GList *next = l->next;
+    MprisPendingCommand *cmd = l->data;
+
+    if (cmd->has_expected_state && (cmd->replied || !only_replied)) {
+      g_cancellable_cancel(cmd->cancellable);
+      g_queue_delete_link(self->pending_commands, l);
+      pending_command_unref(cmd);
+    }
+    l = next;
+  }
+}
+
+/*
+ * Reconciles the state reported by the player with the optimistic state
+ * of the commands still in flight and returns the state to display.
+ */
+static GMprisMediaPlayerState
+resolve_state(GMprisMediaPlayer *self, GMprisMediaPlayerState confirmed)
+{
+  self->confirmed_state = confirmed;
 
+  MprisPendingCommand *cmd = last_state_command(self);
+  if (!cmd) return confirmed;
+
+  if (cmd->expected_state == confirmed) {
+    g_info("%s on %s confirmed after %.1f ms", cmd->method, self->iface,
+           (g_get_monotonic_time() - cmd->issued_time) / 1000.0);
+    drop_state_commands(self, FALSE);
+    return confirmed;
+  }
+
+  // The player has not caught up with the command yet
+  return cmd->expected_state;
+}
+
+/*
+ * Stops everything that wakes the player up. Replies already queued when
+ * the player is disposed may still restart timers, so finalize runs it
+ * again.
+ */
+static void
+g_mpris_media_player_stop_all(GMprisMediaPlayer *self)
+{
   if (self->position_query_cancellable) {
     g_cancellable_cancel(self->position_query_cancellable);
-    g_clear_object(&self->position_query_cancellable);
   }
 
-  stop_position_timer(self);
-  if (self->position_timer) {
-    g_timer_destroy(self->position_timer);
-    self->position_timer = NULL;
+  if (self->init_cancellable) {
+    g_cancellable_cancel(self->init_cancellable);
+  }
+
+  if (self->circuit_probe_id) {
+    g_source_remove(self->circuit_probe_id);
+    self->circuit_probe_id = 0;
+  }
+
+  if (self->deferred_update_id) {
+    g_source_remove(self->deferred_update_id);
+    self->deferred_update_id = 0;
+  }
+
+  if (self->seek_source_id) {
+    g_source_remove(self->seek_source_id);
+    self->seek_source_id = 0;
+  }
+  self->seek_queued = FALSE;
+
+  if (self->volume_source_id) {
+    g_source_remove(self->volume_source_id);
+    self->volume_source_id = 0;
+  }
+  self->volume_queued = FALSE;
+
+  if (self->pending_commands) {
+    cancel_pending_commands(self);
   }
 
+  stop_position_timer(self);
+
   if (self->props_sub_id) {
     g_dbus_connection_signal_unsubscribe(self->conn, self->props_sub_id);
     self->props_sub_id = 0;
@@ -259,15 +511,56 @@ g_mpris_media_player_finalize(GObject * object)
     g_dbus_connection_signal_unsubscribe(self->conn, self->seeked_sub_id);
     self->seeked_sub_id = 0;
   }
+}
+
+/*
+ * Also run by the manager on shutdown, so in flight calls return right away
+ * instead of keeping the player alive until their deadline.
+ */
+static void
+g_mpris_media_player_dispose(GObject * object)
+{
+  g_debug("g_mpris_media_player_dispose entered");
+
+  g_mpris_media_player_stop_all(G_MPRIS_MEDIA_PLAYER(object));
+
+  G_OBJECT_CLASS
+      (g_mpris_media_player_parent_class)->dispose(object);
+
+  g_debug("g_mpris_media_player_dispose exited");
+}
+
+static void
+g_mpris_media_player_finalize(GObject * object)
+{
+  g_debug("g_mpris_media_player_finalize entered");
+
+  GMprisMediaPlayer *self = G_MPRIS_MEDIA_PLAYER(object);
+
+  g_mpris_media_player_stop_all(self);
+
+  g_clear_object(&self->position_query_cancellable);
+  g_clear_object(&self->init_cancellable);
+
+  if (self->pending_commands) {
+    g_queue_free(self->pending_commands);
+    self->pending_commands = NULL;
+  }
 
-  if(self->player_proxy){
-    g_object_unref(self->player_proxy);
-    self->player_proxy = NULL;
+  if (self->position_timer) {
+    g_timer_destroy(self->position_timer);
+    self->position_timer = NULL;
   }
 
+  g_clear_pointer(&self->player_props, g_hash_table_unref);
+
   g_clear_pointer(&self->title, g_free);
   g_clear_pointer(&self->artist, g_free);
+  g_clear_pointer(&self->album, g_free);
   g_clear_pointer(&self->arturl, g_free);
+  g_clear_pointer(&self->track_id, g_free);
+  g_clear_pointer(&self->identity, g_free);
+  g_clear_pointer(&self->desktop_entry, g_free);
 
   g_clear_object(&self->conn);
   g_clear_pointer((gpointer*)&self->iface, g_free);
@@ -296,6 +589,7 @@ g_mpris_media_player_class_init(GMprisMediaPlayerClass * klass)
 
   gobject_class->set_property = g_mpris_media_player_set_property;
   gobject_class->get_property = g_mpris_media_player_get_property;
+  gobject_class->dispose = g_mpris_media_player_dispose;
   gobject_class->finalize = g_mpris_media_player_finalize;
   gobject_class->constructed = g_mpris_media_player_constructed;
 
@@ -342,6 +636,22 @@ g_mpris_media_player_class_init(GMprisMediaPlayerClass * klass)
                         "", // default empty string
                         G_PARAM_READABLE);
 
+  g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_ALBUM] =
+    g_param_spec_string("album",
+                        "Album",
+                        "Current track album",
+                        "", // default empty string
+                        G_PARAM_READABLE);
+
+  g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_TRACK_NUMBER] =
+    g_param_spec_int("track-number",
+                     "Track-Number",
+                     "Current track number in its album, 0 when unknown",
+                     0,
+                     G_MAXINT,
+                     0,
+                     G_PARAM_READABLE);
+
   g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_POSITION] =
     g_param_spec_int64("position",
                        "Position",
@@ -388,6 +698,50 @@ g_mpris_media_player_class_init(GMprisMediaPlayerClass * klass)
                        FALSE,
                        G_PARAM_READABLE);
 
+  g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_IDENTITY] =
+    g_param_spec_string("identity",
+                        "Identity",
+                        "Friendly player name from the MPRIS root interface",
+                        "", // default empty string
+                        G_PARAM_READABLE);
+
+  g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_DESKTOP_ENTRY] =
+    g_param_spec_string("desktop-entry",
+                        "Desktop-Entry",
+                        "Desktop file basename from the MPRIS root interface",
+                        "", // default empty string
+                        G_PARAM_READABLE);
+
+  g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_CAN_RAISE] =
+    g_param_spec_boolean("can-raise",
+                       "Can-Raise",
+                       "If this player support raise command",
+                       FALSE,
+                       G_PARAM_READABLE);
+
+  g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_HAS_TRACK_LIST] =
+    g_param_spec_boolean("has-track-list",
+                       "Has-Track-List",
+                       "If this player implements the TrackList interface",
+                       FALSE,
+                       G_PARAM_READABLE);
+
+  g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_VOLUME] =
+    g_param_spec_double("volume",
+                       "Volume",
+                       "Playback volume, 1 is the normal volume",
+                       0.0,
+                       G_MAXDOUBLE,
+                       0.0,
+                       G_PARAM_READABLE);
+
+  g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_QUARANTINED] =
+    g_param_spec_boolean("quarantined",
+                       "Quarantined",
+                       "If this player is rate limited for flooding events",
+                       FALSE,
+                       G_PARAM_READABLE);
+
   g_mpris_media_player_signals[G_MPRIS_MEDIA_PLAYER_SIGNAL_PROPERTY_CHANGED] =
     g_signal_new("property-changed",
                   G_TYPE_FROM_CLASS(gobject_class),
@@ -421,44 +775,272 @@ g_mpris_media_player_class_init(GMprisMediaPlayerClass * klass)
                   G_TYPE_NONE,
                   0);
 
+  g_mpris_media_player_signals[G_MPRIS_MEDIA_PLAYER_SIGNAL_READY] =
+    g_signal_new("ready",
+                  G_TYPE_FROM_CLASS(gobject_class),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  0,
+                  NULL,
+                  NULL,
+                  NULL,
+                  G_TYPE_NONE,
+                  0);
+
   g_object_class_install_properties (gobject_class,
       G_MPRIS_MEDIA_PLAYER_PROP_LAST, g_mpris_media_player_param_specs);
 }
 
+static void merge_cached_properties(GMprisMediaPlayer *self, GVariant *changed, const gchar **invalidated);
+static void update_root_info(GMprisMediaPlayer *self, GVariant *props);
+static void g_mpris_media_player_update_info(GMprisMediaPlayer* self);
+static void schedule_event(GMprisMediaPlayer *self, gboolean update_info);
+
+static gboolean
+call_allowed(GMprisMediaPlayer *self)
+{
+  return self->conn != NULL && !self->circuit_open;
+}
+
+static gboolean
+is_timeout_error(const GError *error)
+{
+  return g_error_matches(error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT) ||
+         g_error_matches(error, G_DBUS_ERROR, G_DBUS_ERROR_NO_REPLY) ||
+         g_error_matches(error, G_DBUS_ERROR, G_DBUS_ERROR_TIMEOUT) ||
+         g_error_matches(error, G_DBUS_ERROR, G_DBUS_ERROR_TIMED_OUT);
+}
+
+static void schedule_circuit_probe(GMprisMediaPlayer *self);
+
 static void
-on_position_query_complete(GObject *source_object,
+open_circuit(GMprisMediaPlayer *self)
+{
+  if (self->circuit_open) return;
+
+  self->circuit_open = TRUE;
+  self->circuit_backoff = MPRIS_CIRCUIT_BACKOFF_MIN;
+
+  g_warning("Player %s stopped answering after %u timeouts, hiding it",
+            self->iface, self->call_failures);
+
+  stop_position_timer(self);
+  cancel_pending_commands(self);
+  schedule_circuit_probe(self);
+
+  g_signal_emit(self,
+      g_mpris_media_player_signals[G_MPRIS_MEDIA_PLAYER_SIGNAL_PROPERTY_CHANGED],
+      0);
+}
+
+/*
+ * Every reply from the player passes through here. Only timeouts count as
+ * failures: a player answering with an error is alive and responsive.
+ */
+static void
+call_finished(GMprisMediaPlayer *self, const GError *error)
+{
+  if (error && is_timeout_error(error)) {
+    self->call_failures++;
+    g_debug("Call to %s timed out (%u in a row)", self->iface, self->call_failures);
+
+    if (self->call_failures >= MPRIS_CIRCUIT_THRESHOLD) {
+      open_circuit(self);
+    }
+    return;
+  }
+
+  self->call_failures = 0;
+}
+
+static void
+on_circuit_root_complete(GObject *source_object,
+                         GAsyncResult *result,
+                         gpointer user_data)
+{
+  GMprisMediaPlayer *self = G_MPRIS_MEDIA_PLAYER(user_data);
+  MPRIS_REPLY_SCOPE("on_circuit_root_complete", self);
+  GError *error = NULL;
+  GVariant *ret = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source_object), result, &error);
+
+  if (error && g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+    g_error_free(error);
+    g_object_unref(self);
+    return;
+  }
+
+  call_finished(self, error);
+
+  if (!ret) {
+    g_debug("Failed to read root properties of %s: %s", self->iface,
+            error ? error->message : "unknown");
+    g_clear_error(&error);
+    g_object_unref(self);
+    return;
+  }
+
+  mpris_recorder_record(MPRIS_RECORD_REPLY, self->iface, IFACE_ROOT, "GetAll", ret);
+
+  GVariant *props = g_variant_get_child_value(ret, 0);
+  update_root_info(self, props);
+  g_variant_unref(props);
+  g_variant_unref(ret);
+
+  // The identity is shown in the title, have the widget read it again
+  if (self->initialized) {
+    schedule_event(self, FALSE);
+  }
+
+  g_object_unref(self);
+}
+
+static void
+on_circuit_probe_complete(GObject *source_object,
                           GAsyncResult *result,
                           gpointer user_data)
 {
-    GError *error = NULL;
-    GVariant *ret = g_dbus_proxy_call_finish(G_DBUS_PROXY(source_object), result, &error);
+  GMprisMediaPlayer *self = G_MPRIS_MEDIA_PLAYER(user_data);
+  MPRIS_REPLY_SCOPE("on_circuit_probe_complete", self);
+  GError *error = NULL;
+  GVariant *ret = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source_object), result, &error);
 
-    if (ret && !error) {
-        GVariant *value = NULL;
-        g_variant_get(ret, "(v)", &value);
+  if (error && g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+    g_error_free(error);
+    g_object_unref(self);
+    return;
+  }
+
+  if (!ret) {
+    self->circuit_backoff = MIN(self->circuit_backoff * 2, MPRIS_CIRCUIT_BACKOFF_MAX);
+    g_debug("Probe of %s failed (%s), next in %us", self->iface,
+            error ? error->message : "unknown", self->circuit_backoff);
+    g_clear_error(&error);
+    schedule_circuit_probe(self);
+    g_object_unref(self);
+    return;
+  }
+
+  g_info("Player %s answers again, showing it", self->iface);
+
+  self->circuit_open = FALSE;
+  self->call_failures = 0;
+
+  // Whatever changed while the player was hidden is in this reply
+  GVariant *props = g_variant_get_child_value(ret, 0);
+  merge_cached_properties(self, props, NULL);
+  g_variant_unref(props);
+  g_variant_unref(ret);
+
+  if (self->initialized) {
+    g_mpris_media_player_update_info(self);
+  }
+
+  // open_circuit stopped the timer without changing the state, so
+  // set_state does not restart it when the player is still playing
+  if (self->state == G_MPRIS_MEDIA_PLAYER_STATE_PLAYING && !self->position_timer_id) {
+    start_position_timer(self);
+  }
+
+  // The probe only covers the Player interface, Identity, DesktopEntry
+  // and CanRaise may have changed while the player was hidden as well
+  g_dbus_connection_call(self->conn,
+                         self->iface,
+                         MPRIS_PATH,
+                         IFACE_PROPS,
+                         "GetAll",
+                         g_variant_new("(s)", IFACE_ROOT),
+                         G_VARIANT_TYPE("(a{sv})"),
+                         G_DBUS_CALL_FLAGS_NO_AUTO_START,
+                         MPRIS_CALL_TIMEOUT_MS,
+                         self->init_cancellable,
+                         on_circuit_root_complete,
+                         g_object_ref(self));
+
+  g_object_unref(self);
+}
+
+static gboolean
+circuit_probe_callback(gpointer user_data)
+{
+  GMprisMediaPlayer *self = G_MPRIS_MEDIA_PLAYER(user_data);
+  MEDIA_WATCHDOG_SCOPE("circuit_probe_callback", self->iface);
+
+  MEDIA_STATS_INC(MEDIA_STAT_TIMER_WAKEUPS);
+  self->circuit_probe_id = 0;
+
+  g_dbus_connection_call(self->conn,
+                         self->iface,
+                         MPRIS_PATH,
+                         IFACE_PROPS,
+                         "GetAll",
+                         g_variant_new("(s)", IFACE_PLAYER),
+                         G_VARIANT_TYPE("(a{sv})"),
+                         G_DBUS_CALL_FLAGS_NO_AUTO_START,
+                         MPRIS_CALL_TIMEOUT_MS,
+                         self->init_cancellable,
+                         on_circuit_probe_complete,
+                         g_object_ref(self));
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+schedule_circuit_probe(GMprisMediaPlayer *self)
+{
+  if (self->circuit_probe_id > 0) return;
+
+  self->circuit_probe_id = g_timeout_add_seconds(self->circuit_backoff, circuit_probe_callback, self);
+}
+
+static void
+apply_position_reply(GMprisMediaPlayer *self, GVariant *ret)
+{
+    if (!g_variant_is_of_type(ret, G_VARIANT_TYPE("(v)"))) return;
+
+    // The player has not caught up with the seek shown yet
+    if (self->seek_in_flight || self->seek_queued) return;
+
+    GVariant *value = NULL;
+    g_variant_get(ret, "(v)", &value);
+    
+    if (value && g_variant_is_of_type(value, G_VARIANT_TYPE_INT64)) {
+        gint64 new_position = g_variant_get_int64(value);
         
-        if (value && g_variant_is_of_type(value, G_VARIANT_TYPE_INT64)) {
-            gint64 new_position = g_variant_get_int64(value);
-            
-            g_debug("on_position_query_complete: %ld", new_position);
-            if(G_IS_MPRIS_MEDIA_PLAYER(user_data)){
-                GMprisMediaPlayer *self = G_MPRIS_MEDIA_PLAYER(user_data);
- 
-                if (self->position != new_position) {
-                    self->position = new_position;
-                    self->last_known_position = new_position;
+        g_debug("on_position_query_complete: %ld", new_position);
 
-                    if(self->state == G_MPRIS_MEDIA_PLAYER_STATE_PLAYING && self->position_timer) {
-                      g_timer_reset(self->position_timer);
-                    }
+        if (self->position != new_position) {
+            self->position = new_position;
+            self->last_known_position = new_position;
 
-                    g_object_notify_by_pspec(G_OBJECT(self), 
-                      g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_POSITION]);
-                }
+            if(self->state == G_MPRIS_MEDIA_PLAYER_STATE_PLAYING && self->position_timer) {
+              g_timer_reset(self->position_timer);
             }
+
+            g_object_notify_by_pspec(G_OBJECT(self), 
+              g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_POSITION]);
         }
+    }
+
+    if (value) g_variant_unref(value);
+}
 
-        if (value) g_variant_unref(value);
+static void
+on_position_query_complete(GObject *source_object,
+                          GAsyncResult *result,
+                          gpointer user_data)
+{
+    MPRIS_REPLY_SCOPE("on_position_query_complete", G_MPRIS_MEDIA_PLAYER(user_data));
+    GError *error = NULL;
+    GVariant *ret = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source_object), result, &error);
+
+    if (!error || !g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+      call_finished(G_MPRIS_MEDIA_PLAYER(user_data), error);
+    }
+
+    if (ret && !error) {
+        GMprisMediaPlayer *self = G_MPRIS_MEDIA_PLAYER(user_data);
+
+        mpris_recorder_record(MPRIS_RECORD_REPLY, self->iface, IFACE_PROPS, "Get", ret);
+        apply_position_reply(self, ret);
         g_variant_unref(ret);
     }
 
@@ -481,112 +1063,223 @@ on_position_query_complete(GObject *source_object,
 static void
 query_position_async(GMprisMediaPlayer *self)
 {
-    g_dbus_proxy_set_cached_property(self->player_proxy, "Position", NULL);
-    g_dbus_proxy_call(self->player_proxy,
-                     "org.freedesktop.DBus.Properties.Get",
+    if (!call_allowed(self)) return;
+
+    g_hash_table_remove(self->player_props, "Position");
+    g_dbus_connection_call(self->conn,
+                     self->iface,
+                     MPRIS_PATH,
+                     IFACE_PROPS,
+                     "Get",
                      g_variant_new("(ss)", IFACE_PLAYER, "Position"),
-                     G_DBUS_CALL_FLAGS_NONE,
-                     1000, // 1 second timeout
+                     G_VARIANT_TYPE("(v)"),
+                     G_DBUS_CALL_FLAGS_NO_AUTO_START,
+                     MPRIS_CALL_TIMEOUT_MS,
                      self->position_query_cancellable,
                      on_position_query_complete,
                      g_object_ref(self));
 }
 
+static GVariant*
+get_cached_property(GMprisMediaPlayer *self, const char *name)
+{
+  GVariant *value = g_hash_table_lookup(self->player_props, name);
+  return value ? g_variant_ref(value) : NULL;
+}
+
 static void
-g_mpris_media_player_update_info(GMprisMediaPlayer* self){
-  g_return_if_fail(G_IS_MPRIS_MEDIA_PLAYER(self));
+merge_cached_properties(GMprisMediaPlayer *self, GVariant *changed, const gchar **invalidated)
+{
+  GVariantIter iter;
+  const gchar *key = NULL;
+  GVariant *value = NULL;
+
+  g_variant_iter_init(&iter, changed);
+  while (g_variant_iter_next(&iter, "{&sv}", &key, &value)) {
+    if (g_str_equal(key, "Volume")) self->volume_reported = TRUE;
+    g_hash_table_replace(self->player_props, g_strdup(key), value);
+  }
 
-  GMprisMediaPlayerState new_state = G_MPRIS_MEDIA_PLAYER_STATE_IDLE;
+  for (guint i = 0; invalidated && invalidated[i]; i++) {
+    g_hash_table_remove(self->player_props, invalidated[i]);
+  }
+}
 
-  if (self->player_proxy) {
+static void
+update_string(GMprisMediaPlayer *self, gchar **field, const gchar *value, guint prop_id)
+{
+  if (g_strcmp0(*field, value) != 0) {
+    g_free(*field);
+    *field = g_strdup(value ? value : "");
 
-    query_position_async(self);
+    g_object_notify_by_pspec(G_OBJECT(self), g_mpris_media_player_param_specs[prop_id]);
+  }
+}
 
-    GVariant *playback = g_dbus_proxy_get_cached_property(self->player_proxy, "PlaybackStatus");
-    
-    const char* status = "";
-    if (playback && g_variant_is_of_type(playback, G_VARIANT_TYPE_STRING)) {
-      status = g_variant_get_string(playback, NULL);
-      
-      if (g_strcmp0(status, "Playing") == 0) {
-        new_state = G_MPRIS_MEDIA_PLAYER_STATE_PLAYING;
-      } else if (g_strcmp0(status, "Paused") == 0) {
-        new_state = G_MPRIS_MEDIA_PLAYER_STATE_PAUSED;
-      } else if (g_strcmp0(status, "Stopped") == 0) {
-        new_state = G_MPRIS_MEDIA_PLAYER_STATE_STOPPED;
-      } else {
-        new_state = G_MPRIS_MEDIA_PLAYER_STATE_IDLE;
-      }
-    }
+static void
+update_root_info(GMprisMediaPlayer *self, GVariant *props)
+{
+  const gchar *identity = NULL;
+  if (g_variant_lookup(props, "Identity", "&s", &identity)) {
+    update_string(self, &self->identity, identity, G_MPRIS_MEDIA_PLAYER_PROP_IDENTITY);
+  }
 
-    GVariant *metadata = g_dbus_proxy_get_cached_property(self->player_proxy, "Metadata");
+  const gchar *desktop_entry = NULL;
+  if (g_variant_lookup(props, "DesktopEntry", "&s", &desktop_entry)) {
+    update_string(self, &self->desktop_entry, desktop_entry, G_MPRIS_MEDIA_PLAYER_PROP_DESKTOP_ENTRY);
+  }
 
-    const char *new_title = "";
-    const char *new_artist = "";
+  gboolean can_raise = FALSE;
+  if (g_variant_lookup(props, "CanRaise", "b", &can_raise) && can_raise != self->can_raise) {
+    self->can_raise = can_raise;
+    g_object_notify_by_pspec(G_OBJECT(self),
+          g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_CAN_RAISE]);
+  }
 
-    if (metadata && g_variant_is_of_type(metadata, G_VARIANT_TYPE("a{sv}"))) {
+  gboolean has_track_list = FALSE;
+  if (g_variant_lookup(props, "HasTrackList", "b", &has_track_list) && has_track_list != self->has_track_list) {
+    self->has_track_list = has_track_list;
+    g_object_notify_by_pspec(G_OBJECT(self),
+          g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_HAS_TRACK_LIST]);
+  }
 
-      GVariant *v_length = g_variant_lookup_value(metadata, "mpris:length", G_VARIANT_TYPE_INT64);
-      gint64 track_length = 0;
-      if (v_length) {
-        track_length = g_variant_get_int64(v_length);
-        g_variant_unref(v_length);
-      }
+  g_debug("Root info for %s: identity=%s, desktop-entry=%s, can-raise=%s",
+          self->iface, self->identity, self->desktop_entry,
+          self->can_raise ? "TRUE" : "FALSE");
+}
 
-      if(self->length != track_length){
-        self->length = track_length;
+static const struct
+{
+  const gchar *key;
+  const GVariantType *type;
+  GMprisMediaPlayerField field;
+} metadata_keys[] = {
+  { "xesam:title",       G_VARIANT_TYPE_STRING,       G_MPRIS_MEDIA_PLAYER_FIELD_TITLE },
+  { "xesam:artist",      G_VARIANT_TYPE_STRING_ARRAY, G_MPRIS_MEDIA_PLAYER_FIELD_ARTIST },
+  { "xesam:album",       G_VARIANT_TYPE_STRING,       G_MPRIS_MEDIA_PLAYER_FIELD_ALBUM },
+  { "xesam:trackNumber", G_VARIANT_TYPE_INT32,        G_MPRIS_MEDIA_PLAYER_FIELD_TRACK_NUMBER },
+  { "mpris:length",      G_VARIANT_TYPE_INT64,        G_MPRIS_MEDIA_PLAYER_FIELD_LENGTH },
+  { "mpris:artUrl",      G_VARIANT_TYPE_STRING,       G_MPRIS_MEDIA_PLAYER_FIELD_ART_URL },
+  { "mpris:trackid",     G_VARIANT_TYPE_OBJECT_PATH,  G_MPRIS_MEDIA_PLAYER_FIELD_TRACK_ID },
+};
 
-        g_object_notify_by_pspec(G_OBJECT(self), 
-          g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_LENGTH]);
-      }
+static void
+set_metadata_string(GMprisMediaPlayer *self, gchar **dest, const gchar *value, guint prop_id)
+{
+  if (g_strcmp0(*dest, value) == 0) return;
 
-      GVariant *v_title = g_variant_lookup_value(metadata, "xesam:title", G_VARIANT_TYPE_STRING);
-      if (v_title) {
-        new_title = g_variant_get_string(v_title, NULL);
-      }
+  g_free(*dest);
+  *dest = g_strdup(value);
+  MEDIA_STATS_ADD(MEDIA_STAT_METADATA_BYTES, strlen(*dest) + 1);
 
-      GVariant *v_artist = g_variant_lookup_value(metadata, "xesam:artist", G_VARIANT_TYPE("as"));
-      if (v_artist && g_variant_n_children(v_artist) > 0) {
-        //TODO - iterate over artists in the array
-        GVariant *child0 = g_variant_get_child_value(v_artist, 0);
-        new_artist = g_variant_get_string(child0, NULL);
-        g_variant_unref(child0);
-      }
+  g_object_notify_by_pspec(G_OBJECT(self), g_mpris_media_player_param_specs[prop_id]);
+}
 
-      if (g_strcmp0(self->title, new_title) != 0) {
-        g_free(self->title);
-        self->title = g_strdup(new_title ? new_title : "");
+/*
+ * Picks the kept fields out of the a{sv} metadata in a single pass, the
+ * other entries are skipped without being unpacked.
+ */
+static void
+update_metadata(GMprisMediaPlayer *self, GVariant *metadata)
+{
+  GVariant *values[G_N_ELEMENTS(metadata_keys)] = { NULL };
 
-        g_object_notify_by_pspec(G_OBJECT(self), 
-          g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_TITLE]);
-      }
+  GVariantIter iter;
+  const gchar *key;
+  GVariant *value;
 
-      if (g_strcmp0(self->artist, new_artist) != 0) {
-        g_free(self->artist);
-        self->artist = g_strdup(new_artist ? new_artist : "");
+  g_variant_iter_init(&iter, metadata);
+  while (g_variant_iter_next(&iter, "{&sv}", &key, &value)) {
+    guint i;
+    for (i = 0; i < G_N_ELEMENTS(metadata_keys); i++) {
+      if ((self->fields & metadata_keys[i].field) && strcmp(key, metadata_keys[i].key) == 0) break;
+    }
 
-        g_object_notify_by_pspec(G_OBJECT(self), 
-          g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_ARTIST]);
-      }
+    if (i < G_N_ELEMENTS(metadata_keys) && !values[i] &&
+        g_variant_is_of_type(value, metadata_keys[i].type)) {
+      values[i] = value;
+    } else {
+      g_variant_unref(value);
+    }
+  }
 
-      if (v_title) g_variant_unref(v_title);
-      if (v_artist) g_variant_unref(v_artist);
+  // Missing entries and the ones no longer kept fall back to empty
+  const gchar *title = values[0] ? g_variant_get_string(values[0], NULL) : "";
+  const gchar *artist = "";
+  if (values[1] && g_variant_n_children(values[1]) > 0) {
+    //TODO - join all the artists of the array
+    g_variant_get_child(values[1], 0, "&s", &artist);
+  }
+  const gchar *album = values[2] ? g_variant_get_string(values[2], NULL) : "";
+  gint track_number = values[3] ? MAX(g_variant_get_int32(values[3]), 0) : 0;
+  gint64 length = values[4] ? g_variant_get_int64(values[4]) : 0;
+  const gchar *arturl = values[5] ? g_variant_get_string(values[5], NULL) : "";
+  const gchar *track_id = values[6] ? g_variant_get_string(values[6], NULL) : "";
+
+  if (self->length != length) {
+    self->length = length;
+    g_object_notify_by_pspec(G_OBJECT(self),
+      g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_LENGTH]);
+  }
 
-      GVariant *v_arturl = g_variant_lookup_value(metadata, "mpris:artUrl", G_VARIANT_TYPE_STRING);
-      if (v_arturl) {
-        const char *art_url = g_variant_get_string(v_arturl, NULL);
+  set_metadata_string(self, &self->title, title, G_MPRIS_MEDIA_PLAYER_PROP_TITLE);
+  set_metadata_string(self, &self->artist, artist, G_MPRIS_MEDIA_PLAYER_PROP_ARTIST);
+  set_metadata_string(self, &self->album, album, G_MPRIS_MEDIA_PLAYER_PROP_ALBUM);
 
-        if (g_strcmp0(self->arturl, art_url) != 0) {
-          g_free(self->arturl);
-          self->arturl = g_strdup(art_url ? art_url : "");
+  if (self->track_number != track_number) {
+    self->track_number = track_number;
+    g_object_notify_by_pspec(G_OBJECT(self),
+      g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_TRACK_NUMBER]);
+  }
 
-          g_object_notify_by_pspec(G_OBJECT(self), 
-              g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_ARTURL]);
+  set_metadata_string(self, &self->arturl, arturl, G_MPRIS_MEDIA_PLAYER_PROP_ARTURL);
 
-        }
+  // Not a property, it is only sent back with SetPosition
+  if (g_strcmp0(self->track_id, track_id) != 0) {
+    g_free(self->track_id);
+    self->track_id = g_strdup(track_id);
+  }
 
-        g_variant_unref(v_arturl);
+  for (guint i = 0; i < G_N_ELEMENTS(values); i++) {
+    if (values[i]) g_variant_unref(values[i]);
+  }
+}
+
+static void
+g_mpris_media_player_update_info(GMprisMediaPlayer* self){
+  g_return_if_fail(G_IS_MPRIS_MEDIA_PLAYER(self));
+
+  MEDIA_STATS_INC(MEDIA_STAT_UPDATE_INFO);
+  MEDIA_TRACE_SCOPE("update-info", self->iface);
+
+  GMprisMediaPlayerState new_state = G_MPRIS_MEDIA_PLAYER_STATE_IDLE;
+
+  if (self->initialized) {
+
+    query_position_async(self);
+
+    GVariant *playback = get_cached_property(self, "PlaybackStatus");
+    
+    const char* status = "";
+    if (playback && g_variant_is_of_type(playback, G_VARIANT_TYPE_STRING)) {
+      status = g_variant_get_string(playback, NULL);
+      
+      if (g_strcmp0(status, "Playing") == 0) {
+        new_state = G_MPRIS_MEDIA_PLAYER_STATE_PLAYING;
+      } else if (g_strcmp0(status, "Paused") == 0) {
+        new_state = G_MPRIS_MEDIA_PLAYER_STATE_PAUSED;
+      } else if (g_strcmp0(status, "Stopped") == 0) {
+        new_state = G_MPRIS_MEDIA_PLAYER_STATE_STOPPED;
+      } else {
+        new_state = G_MPRIS_MEDIA_PLAYER_STATE_IDLE;
       }
+    }
+
+    GVariant *metadata = get_cached_property(self, "Metadata");
+
+    if (metadata && g_variant_is_of_type(metadata, G_VARIANT_TYPE("a{sv}"))) {
+
+      update_metadata(self, metadata);
 
       g_signal_emit(self, 
             g_mpris_media_player_signals[G_MPRIS_MEDIA_PLAYER_SIGNAL_META_CHANGED], 
@@ -595,15 +1288,15 @@ g_mpris_media_player_update_info(GMprisMediaPlayer* self){
 
 
     char *title_artist = g_strdup("");
-    if(new_artist[0] && new_title[0]){
+    if(self->artist[0] && self->title[0]){
       g_free(title_artist);
-      title_artist = g_strdup_printf("%s-%s", new_artist, new_title);
-    } else if(new_title[0]){
+      title_artist = g_strdup_printf("%s-%s", self->artist, self->title);
+    } else if(self->title[0]){
       g_free(title_artist);
-      title_artist = g_strdup_printf("%s", new_title);
-    } else if(new_artist[0]){
+      title_artist = g_strdup_printf("%s", self->title);
+    } else if(self->artist[0]){
       g_free(title_artist);
-      title_artist = g_strdup_printf("%s", new_artist);
+      title_artist = g_strdup_printf("%s", self->artist);
     }
 
     // ---- "Widget output" (replace with GTK label updates etc.) ----
@@ -618,47 +1311,52 @@ g_mpris_media_player_update_info(GMprisMediaPlayer* self){
     if (metadata) g_variant_unref(metadata);
   }
 
-  if (self->state != new_state) {
-    self->state = new_state;
-
-
-    if(self->state == G_MPRIS_MEDIA_PLAYER_STATE_PLAYING){
-      start_position_timer(self);
-    } else {
-      stop_position_timer(self);
-    }
-
-    g_object_notify_by_pspec(G_OBJECT(self), 
-          g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_STATE]);
-
-    g_signal_emit(self, 
-          g_mpris_media_player_signals[G_MPRIS_MEDIA_PLAYER_SIGNAL_STATE_CHANGED], 
-          0);
-  }
+  set_state(self, resolve_state(self, new_state));
 
   gboolean can_play = FALSE;
-  GVariant *can_play_variant = g_dbus_proxy_get_cached_property(self->player_proxy, "CanPlay");
+  GVariant *can_play_variant = get_cached_property(self, "CanPlay");
   if (can_play_variant && g_variant_is_of_type(can_play_variant, G_VARIANT_TYPE_BOOLEAN)) {
       can_play = g_variant_get_boolean(can_play_variant);
       g_variant_unref(can_play_variant);
   }  
 
   gboolean can_control = FALSE;
-  GVariant *can_control_variant = g_dbus_proxy_get_cached_property(self->player_proxy, "CanControl");
+  GVariant *can_control_variant = get_cached_property(self, "CanControl");
   if (can_control_variant && g_variant_is_of_type(can_control_variant, G_VARIANT_TYPE_BOOLEAN)) {
       can_control = g_variant_get_boolean(can_control_variant);
       g_variant_unref(can_control_variant);
   }
 
+  gboolean can_seek = FALSE;
+  GVariant *can_seek_variant = get_cached_property(self, "CanSeek");
+  if (can_seek_variant && g_variant_is_of_type(can_seek_variant, G_VARIANT_TYPE_BOOLEAN)) {
+      can_seek = g_variant_get_boolean(can_seek_variant);
+      g_variant_unref(can_seek_variant);
+  }
+  self->can_seek = can_seek;
+
+  // Echoes of the writes still pending would undo the newer local value
+  GVariant *volume_variant = get_cached_property(self, "Volume");
+  if (volume_variant && g_variant_is_of_type(volume_variant, G_VARIANT_TYPE_DOUBLE) &&
+      !self->volume_in_flight && !self->volume_queued) {
+    gdouble volume = MAX(g_variant_get_double(volume_variant), 0.0);
+    if (volume != self->volume) {
+      self->volume = volume;
+      g_object_notify_by_pspec(G_OBJECT(self),
+          g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_VOLUME]);
+    }
+  }
+  if (volume_variant) g_variant_unref(volume_variant);
+
   gboolean can_go_next = FALSE;
-  GVariant *can_next_variant = g_dbus_proxy_get_cached_property(self->player_proxy, "CanGoNext");
+  GVariant *can_next_variant = get_cached_property(self, "CanGoNext");
   if (can_next_variant && g_variant_is_of_type(can_next_variant, G_VARIANT_TYPE_BOOLEAN)) {
       can_go_next = g_variant_get_boolean(can_next_variant);
       g_variant_unref(can_next_variant);
   }
 
   gboolean can_go_previous = FALSE;
-  GVariant *can_prev_variant = g_dbus_proxy_get_cached_property(self->player_proxy, "CanGoPrevious");
+  GVariant *can_prev_variant = get_cached_property(self, "CanGoPrevious");
   if (can_prev_variant && g_variant_is_of_type(can_prev_variant, G_VARIANT_TYPE_BOOLEAN)) {
       can_go_previous = g_variant_get_boolean(can_prev_variant);
       g_variant_unref(can_prev_variant);
@@ -704,6 +1402,124 @@ g_mpris_media_player_update_info(GMprisMediaPlayer* self){
 
 }
 
+static void
+account_event_window(GMprisMediaPlayer *self, gint64 now, gboolean deferred)
+{
+  gint64 elapsed = now - self->event_window_start;
+
+  if (elapsed >= G_USEC_PER_SEC) {
+    if (elapsed >= 2 * G_USEC_PER_SEC || self->event_window_deferred == 0) {
+      self->throttled_windows = 0;
+    } else {
+      self->throttled_windows++;
+    }
+
+    if (!self->quarantined && self->throttled_windows >= MPRIS_QUARANTINE_WINDOWS) {
+      self->quarantined = TRUE;
+      g_warning("Player %s floods events (%" G_GUINT64_FORMAT " received, %" G_GUINT64_FORMAT
+                " merged), limiting it to %d updates per second",
+                self->iface, self->events_received, self->events_deferred, MPRIS_QUARANTINE_RATE);
+      g_object_notify_by_pspec(G_OBJECT(self),
+          g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_QUARANTINED]);
+    } else if (self->quarantined && self->throttled_windows == 0) {
+      self->quarantined = FALSE;
+      g_info("Player %s calmed down, lifting its quarantine", self->iface);
+      g_object_notify_by_pspec(G_OBJECT(self),
+          g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_QUARANTINED]);
+    }
+
+    self->event_window_start = now;
+    self->event_window_deferred = 0;
+  }
+
+  if (deferred) {
+    self->events_deferred++;
+    self->event_window_deferred++;
+  }
+}
+
+static gboolean
+take_event_token(GMprisMediaPlayer *self, gint64 now)
+{
+  gdouble rate = self->quarantined ? MPRIS_QUARANTINE_RATE : MPRIS_EVENT_RATE;
+
+  self->event_tokens = MIN(MPRIS_EVENT_BURST,
+      self->event_tokens + rate * (now - self->event_refill_time) / G_USEC_PER_SEC);
+  self->event_refill_time = now;
+
+  if (self->event_tokens < 1.0) return FALSE;
+
+  self->event_tokens -= 1.0;
+  return TRUE;
+}
+
+static void
+process_event(GMprisMediaPlayer *self, gboolean update_info)
+{
+  if (update_info) {
+    g_mpris_media_player_update_info(self);
+  } else {
+    g_signal_emit(self,
+        g_mpris_media_player_signals[G_MPRIS_MEDIA_PLAYER_SIGNAL_PROPERTY_CHANGED],
+        0);
+  }
+}
+
+static gboolean
+deferred_update_callback(gpointer user_data)
+{
+  GMprisMediaPlayer *self = G_MPRIS_MEDIA_PLAYER(user_data);
+  MEDIA_WATCHDOG_SCOPE("deferred_update_callback", self->iface);
+  gboolean update_info = self->deferred_update_info;
+
+  MEDIA_STATS_INC(MEDIA_STAT_TIMER_WAKEUPS);
+
+  self->deferred_update_id = 0;
+  self->deferred_update_info = FALSE;
+
+  if (!take_event_token(self, g_get_monotonic_time())) {
+    self->event_tokens = 0.0;
+  }
+
+  process_event(self, update_info);
+
+  return G_SOURCE_REMOVE;
+}
+
+/*
+ * Events are cheap to receive but expensive to process. The cached state is
+ * always up to date; only the processing is limited per player. Events over
+ * the budget are folded into a single deferred update which sees everything
+ * merged until it runs.
+ */
+static void
+schedule_event(GMprisMediaPlayer *self, gboolean update_info)
+{
+  gint64 now = g_get_monotonic_time();
+
+  self->events_received++;
+
+  if (self->deferred_update_id) {
+    self->deferred_update_info |= update_info;
+    account_event_window(self, now, TRUE);
+    return;
+  }
+
+  if (take_event_token(self, now)) {
+    account_event_window(self, now, FALSE);
+    process_event(self, update_info);
+    return;
+  }
+
+  account_event_window(self, now, TRUE);
+
+  gdouble rate = self->quarantined ? MPRIS_QUARANTINE_RATE : MPRIS_EVENT_RATE;
+  guint delay = (guint)ceil((1.0 - self->event_tokens) * 1000.0 / rate);
+
+  self->deferred_update_info = update_info;
+  self->deferred_update_id = g_timeout_add(MAX(delay, 1), deferred_update_callback, self);
+}
+
 static void
 on_properties_changed(GDBusConnection *connection,
                       const gchar *sender_name,
@@ -714,18 +1530,133 @@ on_properties_changed(GDBusConnection *connection,
                       gpointer user_data)
 {
   GMprisMediaPlayer *self = G_MPRIS_MEDIA_PLAYER(user_data);
+  MEDIA_WATCHDOG_SCOPE("on_properties_changed", self->iface);
+
+  mpris_recorder_record(MPRIS_RECORD_SIGNAL, self->iface, IFACE_PROPS, "PropertiesChanged", parameters);
+  MEDIA_STATS_INC(MEDIA_STAT_DBUS_SIGNALS);
+  self->signals_received++;
 
   const char *iface = NULL;
   GVariant *changed = NULL;
-  g_variant_get(parameters, "(&s@a{sv}as)", &iface, &changed, NULL);
+  const gchar **invalidated = NULL;
+  g_variant_get(parameters, "(&s@a{sv}^a&s)", &iface, &changed, &invalidated);
 
   if (g_strcmp0(iface, IFACE_PLAYER) == 0) {
-    g_mpris_media_player_update_info(self);
+    merge_cached_properties(self, changed, invalidated);
+    if (self->initialized) {
+      schedule_event(self, TRUE);
+    }
+  } else if (g_strcmp0(iface, IFACE_ROOT) == 0) {
+    update_root_info(self, changed);
   }
 
+  g_free(invalidated);
   if (changed) g_variant_unref(changed);
 }
 
+static void
+g_mpris_media_player_init_step_done(GMprisMediaPlayer *self)
+{
+  if (self->pending_init == 0 || --self->pending_init > 0) return;
+
+  self->initialized = TRUE;
+  g_debug("Player %s initialized", self->iface);
+
+  g_mpris_media_player_update_info(self);
+
+  g_signal_emit(self,
+      g_mpris_media_player_signals[G_MPRIS_MEDIA_PLAYER_SIGNAL_READY],
+      0);
+}
+
+static void
+apply_get_all_reply(GMprisMediaPlayer *self, const char *iface_name, GVariant *ret)
+{
+  MEDIA_WATCHDOG_SCOPE("apply_get_all_reply", self->iface);
+
+  if (ret && g_variant_is_of_type(ret, G_VARIANT_TYPE("(a{sv})"))) {
+    GVariant *props = g_variant_get_child_value(ret, 0);
+
+    if (g_strcmp0(iface_name, IFACE_ROOT) == 0) {
+      update_root_info(self, props);
+    } else {
+      merge_cached_properties(self, props, NULL);
+    }
+
+    g_variant_unref(props);
+  }
+
+  g_mpris_media_player_init_step_done(self);
+}
+
+static void
+get_all_complete(GMprisMediaPlayer *self,
+                 const char *iface_name,
+                 GObject *source_object,
+                 GAsyncResult *result)
+{
+  GError *error = NULL;
+  GVariant *ret = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source_object), result, &error);
+
+  if (error) {
+    if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+      g_error_free(error);
+      g_object_unref(self);
+      return;
+    }
+
+    g_warning("Failed to read %s properties of %s: %s", iface_name, self->iface, error->message);
+  }
+
+  call_finished(self, error);
+  g_clear_error(&error);
+
+  mpris_recorder_record(MPRIS_RECORD_REPLY, self->iface, iface_name, "GetAll", ret);
+  apply_get_all_reply(self, iface_name, ret);
+
+  if (ret) g_variant_unref(ret);
+  g_object_unref(self);
+}
+
+static void
+on_root_get_all_complete(GObject *source_object,
+                         GAsyncResult *result,
+                         gpointer user_data)
+{
+  get_all_complete(G_MPRIS_MEDIA_PLAYER(user_data), IFACE_ROOT, source_object, result);
+}
+
+static void
+on_player_get_all_complete(GObject *source_object,
+                           GAsyncResult *result,
+                           gpointer user_data)
+{
+  get_all_complete(G_MPRIS_MEDIA_PLAYER(user_data), IFACE_PLAYER, source_object, result);
+}
+
+static void
+get_all_async(GMprisMediaPlayer *self, const char *iface_name, GAsyncReadyCallback callback)
+{
+  self->pending_init++;
+
+  // Replayed players get their replies from the trace
+  if (!self->conn) return;
+
+  g_dbus_connection_call(self->conn,
+                         self->iface,
+                         MPRIS_PATH,
+                         IFACE_PROPS,
+                         "GetAll",
+                         g_variant_new("(s)", iface_name),
+                         G_VARIANT_TYPE("(a{sv})"),
+                         G_DBUS_CALL_FLAGS_NO_AUTO_START,
+                         MPRIS_INIT_TIMEOUT_MS,
+                         self->init_cancellable,
+                         callback,
+                         g_object_ref(self));
+}
+
+
 static void
 on_seeked(GDBusConnection *connection,
           const gchar *sender_name,
@@ -736,12 +1667,23 @@ on_seeked(GDBusConnection *connection,
           gpointer user_data) {
 
   GMprisMediaPlayer *self = G_MPRIS_MEDIA_PLAYER(user_data);
+  MEDIA_WATCHDOG_SCOPE("on_seeked", self->iface);
+
+  mpris_recorder_record(MPRIS_RECORD_SIGNAL, self->iface, IFACE_PLAYER, "Seeked", parameters);
+  MEDIA_STATS_INC(MEDIA_STAT_DBUS_SIGNALS);
+  self->signals_received++;
  
   gint64 new_position = 0;
   g_variant_get(parameters, "(x)", &new_position);
   
   g_debug("Seeked signal received: new position = %ld microseconds", new_position);
   
+  // A newer target is already shown and about to be sent
+  if (self->seek_queued) {
+    schedule_event(self, FALSE);
+    return;
+  }
+
   if (self->position != new_position) {
     self->position = new_position;
     self->last_known_position = new_position;
@@ -754,9 +1696,7 @@ on_seeked(GDBusConnection *connection,
         g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_POSITION]);
   }
   
-  g_signal_emit(self, 
-      g_mpris_media_player_signals[G_MPRIS_MEDIA_PLAYER_SIGNAL_PROPERTY_CHANGED], 
-      0);
+  schedule_event(self, FALSE);
 }
 
 
@@ -766,21 +1706,11 @@ g_mpris_media_player_new(GDBusConnection* conn, const char* iface){
 
   GMprisMediaPlayer* self = g_object_new(G_TYPE_MPRIS_MEDIA_PLAYER, "connection", conn, "iface", iface, NULL);
 
-  GError *err = NULL;
-  self->player_proxy = g_dbus_proxy_new_sync(
-      self->conn,
-      G_DBUS_PROXY_FLAGS_DO_NOT_AUTO_START,
-      NULL,
-      self->iface,
-      MPRIS_PATH,
-      IFACE_PLAYER,
-      NULL,
-      &err);
-
-  if (!self->player_proxy) {
-    g_critical("Failed to create player proxy for %s: %s\n",
-               self->iface, err ? err->message : "unknown");
-    g_clear_error(&err);
+  if (!self->conn) {
+    // Replayed player, signals and replies are fed by the replayer
+    get_all_async(self, IFACE_ROOT, NULL);
+    get_all_async(self, IFACE_PLAYER, NULL);
+    return self;
   }
 
   self->props_sub_id = g_dbus_connection_signal_subscribe(
@@ -807,7 +1737,10 @@ g_mpris_media_player_new(GDBusConnection* conn, const char* iface){
       self,
       NULL);
 
-  g_mpris_media_player_update_info(self);
+  // Both interfaces are requested back to back, the replies are awaited
+  // together instead of one blocking round trip after the other
+  get_all_async(self, IFACE_ROOT, on_root_get_all_complete);
+  get_all_async(self, IFACE_PLAYER, on_player_get_all_complete);
 
   g_debug("g_mpris_media_player_new exited");
   return self;
@@ -817,13 +1750,16 @@ static void
 g_mpris_media_player_init(GMprisMediaPlayer * self)
 {
   g_debug("g_mpris_media_player_init entered");
-  self->player_proxy = NULL;
+  self->player_props = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_variant_unref);
   self->props_sub_id = 0;
   self->seeked_sub_id = 0;
   self->state = G_MPRIS_MEDIA_PLAYER_STATE_IDLE;
   self->title = g_strdup("");
   self->artist = g_strdup("");
+  self->album = g_strdup("");
+  self->fields = G_MPRIS_MEDIA_PLAYER_FIELD_ALL;
   self->arturl = g_strdup("");
+  self->track_id = g_strdup("");
   self->position = 0;
 
   self->can_go_next = FALSE;
@@ -833,6 +1769,35 @@ g_mpris_media_player_init(GMprisMediaPlayer * self)
 
   self->position_query_cancellable = g_cancellable_new();
 
+  self->pending_init = 0;
+  self->initialized = FALSE;
+  self->init_cancellable = g_cancellable_new();
+
+  self->identity = g_strdup("");
+  self->desktop_entry = g_strdup("");
+  self->can_raise = FALSE;
+
+  self->call_failures = 0;
+  self->circuit_open = FALSE;
+  self->circuit_backoff = MPRIS_CIRCUIT_BACKOFF_MIN;
+  self->circuit_probe_id = 0;
+
+  self->event_tokens = MPRIS_EVENT_BURST;
+  self->event_refill_time = g_get_monotonic_time();
+  self->deferred_update_id = 0;
+  self->deferred_update_info = FALSE;
+  self->signals_received = 0;
+  self->events_received = 0;
+  self->events_deferred = 0;
+  self->event_window_start = self->event_refill_time;
+  self->event_window_deferred = 0;
+  self->throttled_windows = 0;
+  self->quarantined = FALSE;
+
+  self->pending_commands = g_queue_new();
+  self->confirmed_state = G_MPRIS_MEDIA_PLAYER_STATE_IDLE;
+  self->command_confirm_id = 0;
+
   g_debug("g_mpris_media_player_init exited");
 }
 
@@ -859,7 +1824,8 @@ g_is_mpris_media_player_available(GMprisMediaPlayer* self) {
   gchar* artist = g_strstrip(g_strdup(self->artist));
   gchar* title = g_strstrip(g_strdup(self->title));
 
-  gboolean ret =  self->state != G_MPRIS_MEDIA_PLAYER_STATE_IDLE && 
+  gboolean ret =  !self->circuit_open &&
+          self->state != G_MPRIS_MEDIA_PLAYER_STATE_IDLE && 
           self->can_control && 
           self->can_play && 
           (strlen(artist) > 0 || strlen(title) > 0);
@@ -877,53 +1843,650 @@ g_mpris_media_player_is_iface(GMprisMediaPlayer* self, const char* iface) {
   return g_strcmp0(self->iface, iface) == 0;
 }
 
+/*
+ * Position extrapolated from the last one the player reported, exact to
+ * the microsecond unlike the position property which is refreshed 4 times
+ * a second.
+ */
+gint64
+g_mpris_media_player_get_position_estimate(GMprisMediaPlayer* self){
+  g_return_val_if_fail(G_IS_MPRIS_MEDIA_PLAYER(self), 0);
+
+  if (self->state != G_MPRIS_MEDIA_PLAYER_STATE_PLAYING || !self->position_timer) return self->position;
+
+  gint64 position = self->last_known_position + (gint64)(g_timer_elapsed(self->position_timer, NULL) * G_USEC_PER_SEC);
+  if (self->length > 0 && position > self->length) position = self->length;
+
+  return position;
+}
+
+/*
+ * Sets the GMprisMediaPlayerField mask of the metadata the consumer shows.
+ * Fields left out are not parsed and stay empty.
+ */
+void
+g_mpris_media_player_set_fields(GMprisMediaPlayer* self, guint fields){
+  g_return_if_fail(G_IS_MPRIS_MEDIA_PLAYER(self));
+
+  fields |= G_MPRIS_MEDIA_PLAYER_FIELD_REQUIRED;
+  if (self->fields == fields) return;
+
+  self->fields = fields;
+
+  // Parse the cached metadata again so the new mask applies right away
+  GVariant *metadata = self->initialized ? get_cached_property(self, "Metadata") : NULL;
+  if (metadata) {
+    if (g_variant_is_of_type(metadata, G_VARIANT_TYPE("a{sv}"))) update_metadata(self, metadata);
+    g_variant_unref(metadata);
+  }
+}
+
+// Borrowed, valid for the lifetime of the player
+const char*
+g_mpris_media_player_get_bus_name(GMprisMediaPlayer* self){
+  g_return_val_if_fail(G_IS_MPRIS_MEDIA_PLAYER(self), NULL);
+  return self->iface;
+}
+
+/*
+ * Borrowed metadata, valid until the next update of the player. Never NULL,
+ * fields that are not kept or not reported are empty.
+ */
+const gchar*
+g_mpris_media_player_get_title(GMprisMediaPlayer* self){
+  g_return_val_if_fail(G_IS_MPRIS_MEDIA_PLAYER(self), "");
+  return self->title;
+}
+
+const gchar*
+g_mpris_media_player_get_artist(GMprisMediaPlayer* self){
+  g_return_val_if_fail(G_IS_MPRIS_MEDIA_PLAYER(self), "");
+  return self->artist;
+}
+
+const gchar*
+g_mpris_media_player_get_album(GMprisMediaPlayer* self){
+  g_return_val_if_fail(G_IS_MPRIS_MEDIA_PLAYER(self), "");
+  return self->album;
+}
+
+const gchar*
+g_mpris_media_player_get_identity(GMprisMediaPlayer* self){
+  g_return_val_if_fail(G_IS_MPRIS_MEDIA_PLAYER(self), "");
+  return self->identity;
+}
+
+const gchar*
+g_mpris_media_player_get_art_url(GMprisMediaPlayer* self){
+  g_return_val_if_fail(G_IS_MPRIS_MEDIA_PLAYER(self), "");
+  return self->arturl;
+}
+
+gint
+g_mpris_media_player_get_track_number(GMprisMediaPlayer* self){
+  g_return_val_if_fail(G_IS_MPRIS_MEDIA_PLAYER(self), 0);
+  return self->track_number;
+}
+
+static gboolean
+command_confirm_timeout(gpointer user_data)
+{
+  GMprisMediaPlayer *self = G_MPRIS_MEDIA_PLAYER(user_data);
+  MEDIA_WATCHDOG_SCOPE("command_confirm_timeout", self->iface);
+
+  MEDIA_STATS_INC(MEDIA_STAT_TIMER_WAKEUPS);
+  self->command_confirm_id = 0;
+
+  MprisPendingCommand *cmd = last_state_command(self);
+  if (cmd && cmd->replied && self->state != self->confirmed_state) {
+    g_info("%s on %s was never confirmed, rolling back", cmd->method, self->iface);
+  }
+
+  drop_state_commands(self, TRUE);
+  set_state(self, resolve_state(self, self->confirmed_state));
+
+  g_signal_emit(self,
+      g_mpris_media_player_signals[G_MPRIS_MEDIA_PLAYER_SIGNAL_PROPERTY_CHANGED],
+      0);
+
+  return G_SOURCE_REMOVE;
+}
+
 static void
 on_command_complete(GObject *source_object,
                    GAsyncResult *result,
                    gpointer user_data) {
+  MprisPendingCommand *cmd = user_data;
+  GMprisMediaPlayer *self = cmd->player;
+  MPRIS_REPLY_SCOPE("on_command_complete", self);
   GError *error = NULL;
-  GVariant *ret = g_dbus_proxy_call_finish(G_DBUS_PROXY(source_object), result, &error);
-  
+  GVariant *ret = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source_object), result, &error);
+
+  if (error && g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+    // Superseded by a newer command, it is no longer in the queue
+    g_error_free(error);
+    g_object_unref(self);
+    pending_command_unref(cmd);
+    return;
+  }
+
+  call_finished(self, error);
+
+  cmd->replied = TRUE;
+  GList *link = g_queue_find(self->pending_commands, cmd);
+
   if (error) {
     g_warning("MPRIS command failed: %s", error->message);
     g_error_free(error);
+
+    if (link) {
+      g_queue_delete_link(self->pending_commands, link);
+      pending_command_unref(cmd);
+
+      if (cmd->has_expected_state) {
+        // Roll back to what the player last reported
+        set_state(self, resolve_state(self, self->confirmed_state));
+        g_signal_emit(self,
+            g_mpris_media_player_signals[G_MPRIS_MEDIA_PLAYER_SIGNAL_PROPERTY_CHANGED],
+            0);
+      }
+    }
+  } else if (link) {
+    if (cmd->has_expected_state) {
+      if (self->command_confirm_id) g_source_remove(self->command_confirm_id);
+      self->command_confirm_id = g_timeout_add(MPRIS_COMMAND_CONFIRM_MS, command_confirm_timeout, self);
+    } else {
+      g_queue_delete_link(self->pending_commands, link);
+      pending_command_unref(cmd);
+    }
   }
   
   if (ret) g_variant_unref(ret);
+
+  g_object_unref(self);
+  pending_command_unref(cmd);
 }
 
 static void g_mpris_media_player_send_command_async(GMprisMediaPlayer* self, 
-                                            const char* method_name) {
+                                            const char* method_name,
+                                            gboolean has_expected_state,
+                                            GMprisMediaPlayerState expected_state) {
 
   g_return_if_fail(G_IS_MPRIS_MEDIA_PLAYER(self));
-  g_return_if_fail(self->player_proxy != NULL);
 
-  g_dbus_proxy_call(self->player_proxy,
+  if (!call_allowed(self)) {
+    g_debug("Not sending %s to %s, player is not answering", method_name, self->iface);
+    return;
+  }
+
+  gint64 now = g_get_monotonic_time();
+
+  // Double clicks send the command once, Next and Previous are usually
+  // answered before the second click so the queue can not tell
+  if (self->last_command && g_strcmp0(self->last_command, method_name) == 0 &&
+      now - self->last_command_time < MPRIS_COMMAND_COLLAPSE_MS * 1000) {
+    g_debug("Collapsed repeated %s on %s", method_name, self->iface);
+    return;
+  }
+
+  self->last_command = method_name;
+  self->last_command_time = now;
+
+  if (has_expected_state) {
+    // Only the outcome of the newest state command matters
+    GList *l = g_queue_peek_head_link(self->pending_commands);
+    while (l) {
+      GList *next = l->next;
+      MprisPendingCommand *old = l->data;
+      if (old->has_expected_state && !old->replied) {
+        g_cancellable_cancel(old->cancellable);
+        g_queue_delete_link(self->pending_commands, l);
+        pending_command_unref(old);
+      }
+      l = next;
+    }
+  }
+
+  MprisPendingCommand *cmd = g_rc_box_new0(MprisPendingCommand);
+  cmd->player = self;
+  cmd->method = method_name;
+  cmd->has_expected_state = has_expected_state;
+  cmd->expected_state = expected_state;
+  cmd->issued_time = now;
+  cmd->cancellable = g_cancellable_new();
+
+  g_queue_push_tail(self->pending_commands, cmd);
+
+  g_dbus_connection_call(self->conn,
+                   self->iface,
+                   MPRIS_PATH,
+                   IFACE_PLAYER,
                    method_name,
                    NULL,
-                   G_DBUS_CALL_FLAGS_NONE,
-                   -1,
                    NULL,
+                   G_DBUS_CALL_FLAGS_NO_AUTO_START,
+                   MPRIS_CALL_TIMEOUT_MS,
+                   cmd->cancellable,
                    on_command_complete,
-                   self);
+                   g_rc_box_acquire(cmd));
+  g_object_ref(self);
+
+  if (has_expected_state && self->state != expected_state) {
+    set_state(self, expected_state);
+    g_signal_emit(self,
+        g_mpris_media_player_signals[G_MPRIS_MEDIA_PLAYER_SIGNAL_PROPERTY_CHANGED],
+        0);
+  }
 }
 
 void g_mpris_media_player_play(GMprisMediaPlayer* self){
-  g_mpris_media_player_send_command_async(self, "Play");
+  g_mpris_media_player_send_command_async(self, "Play", TRUE, G_MPRIS_MEDIA_PLAYER_STATE_PLAYING);
 }
 void g_mpris_media_player_pause(GMprisMediaPlayer* self){
-  g_mpris_media_player_send_command_async(self, "Pause");
+  g_mpris_media_player_send_command_async(self, "Pause", TRUE, G_MPRIS_MEDIA_PLAYER_STATE_PAUSED);
 }
 void g_mpris_media_player_stop(GMprisMediaPlayer* self){
-  g_mpris_media_player_send_command_async(self, "Stop");
+  g_mpris_media_player_send_command_async(self, "Stop", TRUE, G_MPRIS_MEDIA_PLAYER_STATE_STOPPED);
 }
 void g_mpris_media_player_play_pause(GMprisMediaPlayer* self){
-  g_mpris_media_player_send_command_async(self, "PlayPause");
+  g_return_if_fail(G_IS_MPRIS_MEDIA_PLAYER(self));
+
+  GMprisMediaPlayerState expected = self->state == G_MPRIS_MEDIA_PLAYER_STATE_PLAYING ?
+      G_MPRIS_MEDIA_PLAYER_STATE_PAUSED : G_MPRIS_MEDIA_PLAYER_STATE_PLAYING;
+  g_mpris_media_player_send_command_async(self, "PlayPause", TRUE, expected);
 }
 void g_mpris_media_player_next(GMprisMediaPlayer* self){
-  g_mpris_media_player_send_command_async(self, "Next");
+  g_mpris_media_player_send_command_async(self, "Next", FALSE, G_MPRIS_MEDIA_PLAYER_STATE_IDLE);
 }
 void g_mpris_media_player_previous(GMprisMediaPlayer* self){
-    g_mpris_media_player_send_command_async(self, "Previous");
+  g_mpris_media_player_send_command_async(self, "Previous", FALSE, G_MPRIS_MEDIA_PLAYER_STATE_IDLE);
+}
+
+static void send_seek(GMprisMediaPlayer *self);
+
+static gboolean
+seek_interval_callback(gpointer user_data)
+{
+  GMprisMediaPlayer *self = G_MPRIS_MEDIA_PLAYER(user_data);
+  MEDIA_WATCHDOG_SCOPE("seek_interval_callback", self->iface);
+  self->seek_source_id = 0;
+
+  MEDIA_STATS_INC(MEDIA_STAT_TIMER_WAKEUPS);
+
+  if (self->seek_queued && !self->seek_in_flight) send_seek(self);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+on_seek_complete(GObject *source_object,
+                 GAsyncResult *result,
+                 gpointer user_data)
+{
+  GMprisMediaPlayer *self = G_MPRIS_MEDIA_PLAYER(user_data);
+  MPRIS_REPLY_SCOPE("on_seek_complete", self);
+  GError *error = NULL;
+  GVariant *ret = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source_object), result, &error);
+
+  if (error && g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+    g_error_free(error);
+    g_object_unref(self);
+    return;
+  }
+
+  call_finished(self, error);
+  self->seek_in_flight = FALSE;
+
+  if (error) {
+    g_warning("Seek failed on %s: %s", self->iface, error->message);
+    g_error_free(error);
+  }
+
+  if (ret) g_variant_unref(ret);
+
+  if (self->seek_queued && !self->seek_source_id) send_seek(self);
+
+  g_object_unref(self);
 }
 
+/*
+ * Sends the newest target. SetPosition is ignored by the player unless the
+ * track id matches, players without one get a relative Seek.
+ */
+static void
+send_seek(GMprisMediaPlayer *self)
+{
+  self->seek_queued = FALSE;
+
+  if (!call_allowed(self)) return;
+
+  GVariant *params;
+  const gchar *method;
+
+  if (self->track_id[0] && g_strcmp0(self->track_id, MPRIS_TRACK_LIST_NO_TRACK) != 0) {
+    method = "SetPosition";
+    params = g_variant_new("(ox)", self->track_id, self->seek_target);
+  } else {
+    gint64 now = g_get_monotonic_time();
+    gint64 current = self->seek_base;
+    if (self->state == G_MPRIS_MEDIA_PLAYER_STATE_PLAYING) current += now - self->seek_base_time;
+
+    method = "Seek";
+    params = g_variant_new("(x)", self->seek_target - current);
+  }
+
+  self->seek_base = self->seek_target;
+  self->seek_base_time = g_get_monotonic_time();
+  self->seek_in_flight = TRUE;
+  self->seeks_sent++;
+  MEDIA_STATS_INC(MEDIA_STAT_SEEKS_SENT);
+
+  g_dbus_connection_call(self->conn,
+                   self->iface,
+                   MPRIS_PATH,
+                   IFACE_PLAYER,
+                   method,
+                   params,
+                   NULL,
+                   G_DBUS_CALL_FLAGS_NO_AUTO_START,
+                   MPRIS_CALL_TIMEOUT_MS,
+                   self->position_query_cancellable,
+                   on_seek_complete,
+                   g_object_ref(self));
+
+  self->seek_source_id = g_timeout_add(MPRIS_SEEK_INTERVAL_MS, seek_interval_callback, self);
+}
+
+/*
+ * Moves to position, in microseconds. The position is shown right away and
+ * bursts of calls, like a scrolling wheel, are merged into at most one
+ * call per MPRIS_SEEK_INTERVAL_MS.
+ */
+void
+g_mpris_media_player_set_position(GMprisMediaPlayer* self, gint64 position){
+  g_return_if_fail(G_IS_MPRIS_MEDIA_PLAYER(self));
+
+  if (!self->can_seek || !call_allowed(self)) {
+    g_debug("Not seeking %s, the player can not seek", self->iface);
+    return;
+  }
+
+  position = MAX(position, 0);
+  if (self->length > 0) position = MIN(position, self->length);
+
+  gboolean throttled = self->seek_in_flight || self->seek_source_id;
+  if (!throttled) {
+    self->seek_base = g_mpris_media_player_get_position_estimate(self);
+    self->seek_base_time = g_get_monotonic_time();
+  }
+
+  self->seek_target = position;
+  self->position = position;
+  self->last_known_position = position;
+  if (self->state == G_MPRIS_MEDIA_PLAYER_STATE_PLAYING && self->position_timer) {
+    g_timer_reset(self->position_timer);
+  }
+  g_object_notify_by_pspec(G_OBJECT(self),
+      g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_POSITION]);
+
+  if (!throttled) {
+    send_seek(self);
+  } else if (self->seek_queued) {
+    // The queued target never reaches the player
+    self->seeks_collapsed++;
+    MEDIA_STATS_INC(MEDIA_STAT_SEEKS_COLLAPSED);
+  } else {
+    self->seek_queued = TRUE;
+  }
+}
+
+static void send_volume(GMprisMediaPlayer *self);
+
+static gboolean
+volume_interval_callback(gpointer user_data)
+{
+  GMprisMediaPlayer *self = G_MPRIS_MEDIA_PLAYER(user_data);
+  MEDIA_WATCHDOG_SCOPE("volume_interval_callback", self->iface);
+  self->volume_source_id = 0;
+
+  MEDIA_STATS_INC(MEDIA_STAT_TIMER_WAKEUPS);
+
+  if (self->volume_queued && !self->volume_in_flight) send_volume(self);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+on_volume_complete(GObject *source_object,
+                   GAsyncResult *result,
+                   gpointer user_data)
+{
+  GMprisMediaPlayer *self = G_MPRIS_MEDIA_PLAYER(user_data);
+  MPRIS_REPLY_SCOPE("on_volume_complete", self);
+  GError *error = NULL;
+  GVariant *ret = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source_object), result, &error);
+
+  if (error && g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+    g_error_free(error);
+    g_object_unref(self);
+    return;
+  }
+
+  call_finished(self, error);
+  self->volume_in_flight = FALSE;
+
+  if (error) {
+    g_warning("Setting the volume failed on %s: %s", self->iface, error->message);
+    g_error_free(error);
+  } else if (!self->volume_reported) {
+    // Not every player emits PropertiesChanged for its volume, the cached
+    // value would otherwise undo the write on the next update
+    g_hash_table_replace(self->player_props, g_strdup("Volume"),
+                         g_variant_ref_sink(g_variant_new_double(self->volume_target)));
+  }
+
+  if (ret) g_variant_unref(ret);
+
+  if (self->volume_queued) {
+    if (!self->volume_source_id) send_volume(self);
+  } else {
+    // Settled, show what the player ended up with
+    if (self->initialized) schedule_event(self, TRUE);
+  }
+
+  g_object_unref(self);
+}
+
+static void
+send_volume(GMprisMediaPlayer *self)
+{
+  self->volume_queued = FALSE;
+
+  if (!call_allowed(self)) return;
+
+  self->volume_in_flight = TRUE;
+  self->volume_reported = FALSE;
+  self->volume_writes++;
+  MEDIA_STATS_INC(MEDIA_STAT_VOLUME_WRITES);
+
+  g_dbus_connection_call(self->conn,
+                   self->iface,
+                   MPRIS_PATH,
+                   IFACE_PROPS,
+                   "Set",
+                   g_variant_new("(ssv)", IFACE_PLAYER, "Volume", g_variant_new_double(self->volume_target)),
+                   NULL,
+                   G_DBUS_CALL_FLAGS_NO_AUTO_START,
+                   MPRIS_CALL_TIMEOUT_MS,
+                   self->position_query_cancellable,
+                   on_volume_complete,
+                   g_object_ref(self));
+
+  self->volume_source_id = g_timeout_add(MPRIS_VOLUME_INTERVAL_MS, volume_interval_callback, self);
+}
+
+/*
+ * Sets the volume, 1 being the normal volume. Shown right away, writes are
+ * merged so only one Properties.Set per player is ever outstanding.
+ */
+void
+g_mpris_media_player_set_volume(GMprisMediaPlayer* self, gdouble volume){
+  g_return_if_fail(G_IS_MPRIS_MEDIA_PLAYER(self));
+
+  if (!self->can_control || !call_allowed(self)) {
+    g_debug("Not setting the volume of %s, the player can not be controlled", self->iface);
+    return;
+  }
+
+  volume = MAX(volume, 0.0);
+  if (volume == self->volume && !self->volume_in_flight && !self->volume_queued) return;
+
+  self->volume_target = volume;
+  if (volume != self->volume) {
+    self->volume = volume;
+    g_object_notify_by_pspec(G_OBJECT(self),
+        g_mpris_media_player_param_specs[G_MPRIS_MEDIA_PLAYER_PROP_VOLUME]);
+  }
+
+  if (!self->volume_in_flight && !self->volume_source_id) {
+    send_volume(self);
+  } else if (self->volume_queued) {
+    self->volume_collapsed++;
+    MEDIA_STATS_INC(MEDIA_STAT_VOLUME_COLLAPSED);
+  } else {
+    self->volume_queued = TRUE;
+  }
+}
+
+static void
+on_raise_complete(GObject *source_object,
+                  GAsyncResult *result,
+                  gpointer user_data)
+{
+  GMprisMediaPlayer *self = G_MPRIS_MEDIA_PLAYER(user_data);
+  MPRIS_REPLY_SCOPE("on_raise_complete", self);
+  GError *error = NULL;
+  GVariant *ret = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source_object), result, &error);
+
+  call_finished(self, error);
+
+  if (error) {
+    g_warning("Raise failed on %s: %s", self->iface, error->message);
+    g_error_free(error);
+  }
+
+  if (ret) g_variant_unref(ret);
+  g_object_unref(self);
+}
+
+/*
+ * Brings the player's window to the front, Raise lives on the root
+ * interface so it does not go through the command queue.
+ */
+void
+g_mpris_media_player_raise(GMprisMediaPlayer* self){
+  g_return_if_fail(G_IS_MPRIS_MEDIA_PLAYER(self));
+
+  if (!self->can_raise || !call_allowed(self)) {
+    g_debug("Not raising %s, the player can not be raised", self->iface);
+    return;
+  }
+
+  g_dbus_connection_call(self->conn,
+                   self->iface,
+                   MPRIS_PATH,
+                   IFACE_ROOT,
+                   "Raise",
+                   NULL,
+                   NULL,
+                   G_DBUS_CALL_FLAGS_NO_AUTO_START,
+                   MPRIS_CALL_TIMEOUT_MS,
+                   NULL,
+                   on_raise_complete,
+                   g_object_ref(self));
+}
+
+void
+g_mpris_media_player_replay(GMprisMediaPlayer* self, MprisRecordKind kind,
+                            const gchar* iface, const gchar* member, GVariant* body){
+  g_return_if_fail(G_IS_MPRIS_MEDIA_PLAYER(self));
+
+  if (kind == MPRIS_RECORD_SIGNAL) {
+    if (g_strcmp0(member, "PropertiesChanged") == 0 &&
+        g_variant_is_of_type(body, G_VARIANT_TYPE("(sa{sv}as)"))) {
+      on_properties_changed(NULL, self->iface, MPRIS_PATH, iface, member, body, self);
+    } else if (g_strcmp0(member, "Seeked") == 0 &&
+               g_variant_is_of_type(body, G_VARIANT_TYPE("(x)"))) {
+      on_seeked(NULL, self->iface, MPRIS_PATH, iface, member, body, self);
+    }
+  } else if (g_strcmp0(member, "GetAll") == 0) {
+    apply_get_all_reply(self, iface, body);
+  } else if (g_strcmp0(member, "Get") == 0) {
+    apply_position_reply(self, body);
+  }
+}
+
+static gsize
+string_size(const gchar* str)
+{
+  return str ? strlen(str) + 1 : 0;
+}
+
+gsize
+g_mpris_media_player_get_memory(GMprisMediaPlayer* self, GMprisMediaPlayerMemory* memory){
+  g_return_val_if_fail(G_IS_MPRIS_MEDIA_PLAYER(self), 0);
+
+  GMprisMediaPlayerMemory m = {0};
+
+  m.object = sizeof(GMprisMediaPlayer);
+
+  m.strings = string_size(self->iface) + string_size(self->title) +
+              string_size(self->artist) + string_size(self->album) + string_size(self->arturl) +
+              string_size(self->track_id) +
+              string_size(self->identity) + string_size(self->desktop_entry);
+
+  if (self->player_props) {
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, self->player_props);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+      m.variants += string_size(key) + g_variant_get_size(value);
+    }
+  }
+
+  // Every pending timeout holds one GSource
+  guint sources = (self->position_timer_id != 0) + (self->deferred_update_id != 0) +
+                  (self->circuit_probe_id != 0) + (self->command_confirm_id != 0) +
+                  (self->seek_source_id != 0) + (self->volume_source_id != 0);
+  m.timers = sources * sizeof(GSource) + (self->position_timer ? 3 * sizeof(guint64) : 0);
+
+  if (self->pending_commands) {
+    m.commands = g_queue_get_length(self->pending_commands) * sizeof(MprisPendingCommand);
+  }
+
+  if (memory) *memory = m;
+
+  return m.object + m.strings + m.variants + m.timers + m.commands;
+}
+
+void
+g_mpris_media_player_append_stats(GMprisMediaPlayer* self, GString* out){
+  g_return_if_fail(G_IS_MPRIS_MEDIA_PLAYER(self));
+
+  GMprisMediaPlayerMemory m;
+  gsize total = g_mpris_media_player_get_memory(self, &m);
+
+  g_string_append_printf(out,
+      "player %s: signals=%" G_GUINT64_FORMAT " events=%" G_GUINT64_FORMAT
+      " merged=%" G_GUINT64_FORMAT " seeks=%" G_GUINT64_FORMAT " seeks-collapsed=%" G_GUINT64_FORMAT
+      " volume-writes=%" G_GUINT64_FORMAT " volume-collapsed=%" G_GUINT64_FORMAT
+      " quarantined=%s circuit-open=%s\n",
+      self->iface, self->signals_received, self->events_received, self->events_deferred,
+      self->seeks_sent, self->seeks_collapsed, self->volume_writes, self->volume_collapsed,
+      self->quarantined ? "yes" : "no", self->circuit_open ? "yes" : "no");
+  g_string_append_printf(out,
+      "player %s memory: total=%" G_GSIZE_FORMAT " object=%" G_GSIZE_FORMAT
+      " strings=%" G_GSIZE_FORMAT " variants=%" G_GSIZE_FORMAT
+      " timers=%" G_GSIZE_FORMAT " commands=%" G_GSIZE_FORMAT "\n",
+      self->iface, total, m.object, m.strings, m.variants, m.timers, m.commands);
+}
@@ -19,10 +19,45 @@
 #include <glib.h>
 #include <gio/gio.h>
 
+#include "mpris_recorder.h"
+
 #define MPRIS_PATH "/org/mpris/MediaPlayer2"
+#define IFACE_ROOT "org.mpris.MediaPlayer2"
 #define IFACE_PLAYER "org.mpris.MediaPlayer2.Player"
 #define IFACE_PROPS "org.freedesktop.DBus.Properties"
 
+// Deadlines for calls to players, a hung player must never be waited on
+// for the 25s D-Bus default
+#define MPRIS_CALL_TIMEOUT_MS       1000
+#define MPRIS_INIT_TIMEOUT_MS       2000
+
+// Consecutive timeouts before a player is hidden and no longer called
+#define MPRIS_CIRCUIT_THRESHOLD     3
+#define MPRIS_CIRCUIT_BACKOFF_MIN   2
+#define MPRIS_CIRCUIT_BACKOFF_MAX   60
+
+// Events processed per second per player, anything above is merged into
+// the next update. Players throttled for several seconds in a row are
+// quarantined at a lower rate until they calm down.
+#define MPRIS_EVENT_RATE            10
+#define MPRIS_EVENT_BURST           20
+#define MPRIS_QUARANTINE_RATE       2
+#define MPRIS_QUARANTINE_WINDOWS    5
+
+// Repeated commands inside this window are sent once. State commands are
+// shown at once and rolled back if the player has not confirmed them this
+// long after answering.
+#define MPRIS_COMMAND_COLLAPSE_MS   300
+#define MPRIS_COMMAND_CONFIRM_MS    1000
+
+// At most one seek is sent per interval and only one is in flight, the
+// targets asked for in between are merged into the newest
+#define MPRIS_SEEK_INTERVAL_MS      150
+
+// Same for Volume writes. The value shown is the local one until the last
+// write is answered, the player's echoes of older values are ignored.
+#define MPRIS_VOLUME_INTERVAL_MS    100
+
 typedef enum _GMprisMediaPlayerState
 {
   G_MPRIS_MEDIA_PLAYER_STATE_IDLE,
@@ -31,6 +66,25 @@ typedef enum _GMprisMediaPlayerState
   G_MPRIS_MEDIA_PLAYER_STATE_PLAYING,
 } GMprisMediaPlayerState;
 
+/*
+ * Metadata entries a player parses and keeps. Title and artist are always
+ * kept, they decide whether the player is shown at all.
+ */
+typedef enum _GMprisMediaPlayerField
+{
+  G_MPRIS_MEDIA_PLAYER_FIELD_TITLE        = 1 << 0,
+  G_MPRIS_MEDIA_PLAYER_FIELD_ARTIST       = 1 << 1,
+  G_MPRIS_MEDIA_PLAYER_FIELD_ALBUM        = 1 << 2,
+  G_MPRIS_MEDIA_PLAYER_FIELD_TRACK_NUMBER = 1 << 3,
+  G_MPRIS_MEDIA_PLAYER_FIELD_LENGTH       = 1 << 4,
+  G_MPRIS_MEDIA_PLAYER_FIELD_ART_URL      = 1 << 5,
+  G_MPRIS_MEDIA_PLAYER_FIELD_TRACK_ID     = 1 << 6,
+  G_MPRIS_MEDIA_PLAYER_FIELD_ALL          = (1 << 7) - 1,
+} GMprisMediaPlayerField;
+
+#define G_MPRIS_MEDIA_PLAYER_FIELD_REQUIRED \
+  (G_MPRIS_MEDIA_PLAYER_FIELD_TITLE | G_MPRIS_MEDIA_PLAYER_FIELD_ARTIST)
+
 GType g_mpris_media_player_state_get_type(void);
 #define G_TYPE_MPRIS_MEDIA_PLAYER_STATE (g_mpris_media_player_state_get_type())
 
@@ -50,9 +104,31 @@ typedef struct _GMprisMediaPlayerClass
 #define G_MPRIS_MEDIA_PLAYER_CLASS(klass)                 (G_TYPE_CHECK_CLASS_CAST ((klass), G_MPRIS_MEDIA_PLAYER, GMprisMediaPlayerClass))
 #define G_MPRIS_MEDIA_PLAYER_CAST(obj)                    ((GtkMprisMediaPlayer*)(obj))
 
+/*
+ * Bytes retained by a player. Variants are counted by their serialized
+ * size and GLib bookkeeping by struct size, so this is an estimate.
+ */
+typedef struct _GMprisMediaPlayerMemory
+{
+  gsize object;
+  gsize strings;
+  gsize variants;
+  gsize timers;
+  gsize commands;
+} GMprisMediaPlayerMemory;
+
 GType g_mpris_media_player_get_type(void);
 GMprisMediaPlayer* g_mpris_media_player_new(GDBusConnection*, const char*);
 gboolean g_mpris_media_player_is_iface(GMprisMediaPlayer*, const char*);
+const char* g_mpris_media_player_get_bus_name(GMprisMediaPlayer* self);
+const gchar* g_mpris_media_player_get_title(GMprisMediaPlayer* self);
+const gchar* g_mpris_media_player_get_artist(GMprisMediaPlayer* self);
+const gchar* g_mpris_media_player_get_album(GMprisMediaPlayer* self);
+const gchar* g_mpris_media_player_get_identity(GMprisMediaPlayer* self);
+const gchar* g_mpris_media_player_get_art_url(GMprisMediaPlayer* self);
+gint g_mpris_media_player_get_track_number(GMprisMediaPlayer* self);
+void g_mpris_media_player_set_fields(GMprisMediaPlayer* self, guint fields);
+gint64 g_mpris_media_player_get_position_estimate(GMprisMediaPlayer* self);
 
 int g_mpris_media_player_compare(const void* a, const void* b);
 gboolean g_is_mpris_media_player_available(GMprisMediaPlayer* self);
@@ -63,5 +139,14 @@ void g_mpris_media_player_stop(GMprisMediaPlayer* self);
 void g_mpris_media_player_play_pause(GMprisMediaPlayer* self);
 void g_mpris_media_player_next(GMprisMediaPlayer* self);
 void g_mpris_media_player_previous(GMprisMediaPlayer* self);
+void g_mpris_media_player_set_position(GMprisMediaPlayer* self, gint64 position);
+void g_mpris_media_player_set_volume(GMprisMediaPlayer* self, gdouble volume);
+void g_mpris_media_player_raise(GMprisMediaPlayer* self);
+
+void g_mpris_media_player_replay(GMprisMediaPlayer* self, MprisRecordKind kind,
+                                 const gchar* iface, const gchar* member, GVariant* body);
+
+void g_mpris_media_player_append_stats(GMprisMediaPlayer* self, GString* out);
+gsize g_mpris_media_player_get_memory(GMprisMediaPlayer* self, GMprisMediaPlayerMemory* memory);
 
 G_END_DECLS
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define G_LOG_DOMAIN "waybarmediaplayer.mpris-recorder"
+
+#include <glib.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "mpris_recorder.h"
+
+static gsize record_init = 0;
+static FILE* record_file = NULL;
+static gint64 record_start = 0;
+
+struct _MprisReplayer
+{
+  GPtrArray* records;
+  guint next;
+  gdouble speed;
+
+  gint64 start_time;
+  clock_t start_cpu;
+  guint source_id;
+
+  MprisReplayDispatch dispatch;
+  gpointer target;
+};
+
+gboolean
+mpris_recorder_is_recording(void){
+  if(g_once_init_enter(&record_init)){
+    const gchar* path = g_getenv(MPRIS_RECORD_ENV);
+
+    if(path && path[0]){
+      record_file = fopen(path, "wb");
+      if(record_file){
+        fwrite(MPRIS_TRACE_MAGIC, 1, strlen(MPRIS_TRACE_MAGIC), record_file);
+        record_start = g_get_monotonic_time();
+        g_info("Recording MPRIS traffic to %s", path);
+      } else {
+        g_warning("Can not open record file %s: %s", path, g_strerror(errno));
+      }
+    }
+
+    g_once_init_leave(&record_init, 1);
+  }
+
+  return record_file != NULL;
+}
+
+/*
+ * Appends one message to the trace. The body is not consumed, NULL records
+ * a failed call.
+ */
+void
+mpris_recorder_record(MprisRecordKind kind, const gchar* bus_name,
+                      const gchar* iface, const gchar* member, GVariant* body){
+  if(!mpris_recorder_is_recording()) return;
+
+  GVariant* record = g_variant_ref_sink(g_variant_new(MPRIS_TRACE_RECORD_TYPE,
+                        (guint64)(g_get_monotonic_time() - record_start),
+                        (guchar)kind,
+                        bus_name ? bus_name : "",
+                        iface ? iface : "",
+                        member ? member : "",
+                        body ? body : g_variant_new("()")));
+
+  guint32 size = GUINT32_TO_LE(g_variant_get_size(record));
+  fwrite(&size, sizeof(size), 1, record_file);
+  fwrite(g_variant_get_data(record), 1, g_variant_get_size(record), record_file);
+  // Traces are taken from sessions that may end in a crash
+  fflush(record_file);
+
+  g_variant_unref(record);
+}
+
+MprisReplayer*
+mpris_replayer_new_from_env(void){
+  const gchar* path = g_getenv(MPRIS_REPLAY_ENV);
+  if(!path || !path[0]) return NULL;
+
+  gchar* contents = NULL;
+  gsize length = 0;
+  GError* err = NULL;
+
+  if(!g_file_get_contents(path, &contents, &length, &err)){
+    g_warning("Can not read replay file %s: %s", path, err->message);
+    g_error_free(err);
+    return NULL;
+  }
+
+  gsize magic_len = strlen(MPRIS_TRACE_MAGIC);
+  if(length < magic_len || memcmp(contents, MPRIS_TRACE_MAGIC, magic_len) != 0){
+    g_warning("%s is not a MPRIS trace", path);
+    g_free(contents);
+    return NULL;
+  }
+
+  MprisReplayer* self = g_new0(MprisReplayer, 1);
+  self->records = g_ptr_array_new_with_free_func((GDestroyNotify)g_variant_unref);
+
+  const gchar* speed = g_getenv(MPRIS_REPLAY_SPEED_ENV);
+  self->speed = speed ? g_ascii_strtod(speed, NULL) : 1.0;
+  if(self->speed < 0) self->speed = 1.0;
+
+  gsize offset = magic_len;
+  while(offset + sizeof(guint32) <= length){
+    guint32 size;
+    memcpy(&size, contents + offset, sizeof(size));
+    size = GUINT32_FROM_LE(size);
+    offset += sizeof(size);
+
+    if(size > length - offset){
+      g_warning("Replay file %s is truncated", path);
+      break;
+    }
+
+    GVariant* record = g_variant_new_from_data(G_VARIANT_TYPE(MPRIS_TRACE_RECORD_TYPE),
+                          g_memdup2(contents + offset, size), size, FALSE, g_free, NULL);
+    g_ptr_array_add(self->records, g_variant_ref_sink(record));
+    offset += size;
+  }
+
+  g_free(contents);
+
+  g_info("Loaded %u records from %s, replaying at %.1fx", self->records->len, path, self->speed);
+  return self;
+}
+
+static void mpris_replayer_schedule(MprisReplayer* self);
+
+static gboolean
+mpris_replayer_callback(gpointer user_data){
+  MprisReplayer* self = user_data;
+  self->source_id = 0;
+
+  gint64 elapsed = g_get_monotonic_time() - self->start_time;
+
+  while(self->next < self->records->len){
+    GVariant* record = g_ptr_array_index(self->records, self->next);
+
+    guint64 time;
+    guchar kind;
+    const gchar *bus_name, *iface, *member;
+    GVariant* body;
+    g_variant_get(record, "(ty&s&s&sv)", &time, &kind, &bus_name, &iface, &member, &body);
+
+    if(self->speed > 0 && time / self->speed > elapsed){
+      g_variant_unref(body);
+      break;
+    }
+
+    self->next++;
+    self->dispatch(self->target, kind, bus_name, iface, member, body);
+    g_variant_unref(body);
+  }
+
+  mpris_replayer_schedule(self);
+  return G_SOURCE_REMOVE;
+}
+
+static void
+mpris_replayer_schedule(MprisReplayer* self){
+  if(self->next >= self->records->len){
+    g_info("Replayed %u records in %.1f ms (%.1f ms CPU)", self->records->len,
+           (g_get_monotonic_time() - self->start_time) / 1000.0,
+           (clock() - self->start_cpu) * 1000.0 / CLOCKS_PER_SEC);
+    return;
+  }
+
+  guint delay = 0;
+  if(self->speed > 0){
+    GVariant* record = g_ptr_array_index(self->records, self->next);
+    GVariant* time = g_variant_get_child_value(record, 0);
+    gint64 due = g_variant_get_uint64(time) / self->speed;
+    gint64 elapsed = g_get_monotonic_time() - self->start_time;
+    g_variant_unref(time);
+
+    if(due > elapsed) delay = (due - elapsed) / 1000;
+  }
+
+  self->source_id = g_timeout_add(delay, mpris_replayer_callback, self);
+}
+
+void
+mpris_replayer_start(MprisReplayer* self, MprisReplayDispatch dispatch, gpointer target){
+  g_return_if_fail(self != NULL && dispatch != NULL);
+
+  self->dispatch = dispatch;
+  self->target = target;
+  self->next = 0;
+  self->start_time = g_get_monotonic_time();
+  self->start_cpu = clock();
+
+  mpris_replayer_schedule(self);
+}
+
+void
+mpris_replayer_free(MprisReplayer* self){
+  if(!self) return;
+
+  if(self->source_id){
+    g_source_remove(self->source_id);
+    self->source_id = 0;
+  }
+
+  g_ptr_array_unref(self->records);
+  g_free(self);
+}
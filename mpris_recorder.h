@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+// Set to a file path to record the MPRIS traffic seen by the module
+#define MPRIS_RECORD_ENV        "WAYBAR_MEDIAPLAYER_RECORD"
+// Set to a recorded file to replay it instead of watching the session bus
+#define MPRIS_REPLAY_ENV        "WAYBAR_MEDIAPLAYER_REPLAY"
+// Replay speed factor, 1 is real time and 0 is as fast as possible
+#define MPRIS_REPLAY_SPEED_ENV  "WAYBAR_MEDIAPLAYER_REPLAY_SPEED"
+
+#define MPRIS_TRACE_MAGIC       "WBMPTRC1"
+
+/*
+ * Every record is a length prefixed serialized GVariant of type
+ * MPRIS_TRACE_RECORD_TYPE:
+ *   (time in us since the recording started, kind, bus name, interface,
+ *    member, body)
+ */
+#define MPRIS_TRACE_RECORD_TYPE "(tysssv)"
+
+typedef enum _MprisRecordKind
+{
+  MPRIS_RECORD_SIGNAL,
+  MPRIS_RECORD_REPLY,
+} MprisRecordKind;
+
+typedef void (*MprisReplayDispatch)(gpointer target,
+                                    MprisRecordKind kind,
+                                    const gchar* bus_name,
+                                    const gchar* iface,
+                                    const gchar* member,
+                                    GVariant* body);
+
+gboolean mpris_recorder_is_recording(void);
+void mpris_recorder_record(MprisRecordKind kind, const gchar* bus_name,
+                           const gchar* iface, const gchar* member, GVariant* body);
+
+typedef struct _MprisReplayer MprisReplayer;
+
+MprisReplayer* mpris_replayer_new_from_env(void);
+void mpris_replayer_start(MprisReplayer* self, MprisReplayDispatch dispatch, gpointer target);
+void mpris_replayer_free(MprisReplayer* self);
+
+G_END_DECLS
@@ -0,0 +1,506 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define G_LOG_DOMAIN "waybarmediaplayer.mpris-track-list"
+
+#include <glib.h>
+#include <gio/gio.h>
+#include <string.h>
+
+#include "mpris_track_list.h"
+#include "mpris_media_player.h"
+#include "media_stats.h"
+#include "media_watchdog.h"
+
+typedef struct _MprisTrack
+{
+  gchar* title;
+  gchar* artist;
+  // Link in the LRU queue, its data is the cache key
+  GList* lru;
+} MprisTrack;
+
+struct _MprisTrackList
+{
+  GDBusConnection* conn;
+  gchar* bus_name;
+  GCancellable* cancellable;
+  guint sub_id;
+
+  // Track ids in play order
+  GPtrArray* ids;
+  // Track id to MprisTrack, bounded to MPRIS_TRACK_LIST_CACHE_SIZE
+  GHashTable* tracks;
+  // Most recently shown first
+  GQueue lru;
+  // Track ids whose page is being fetched
+  GHashTable* pending;
+
+  MprisTrackListChanged changed;
+  gpointer user_data;
+};
+
+// One GetTracksMetadata call, outlives the list when it is cancelled
+typedef struct _MprisTrackPage
+{
+  MprisTrackList* list;
+  gchar** ids;
+} MprisTrackPage;
+
+static void
+mpris_track_free(gpointer data){
+  MprisTrack* track = data;
+
+  g_free(track->title);
+  g_free(track->artist);
+  g_free(track);
+}
+
+static void
+mpris_track_list_forget(MprisTrackList* self, const gchar* id){
+  MprisTrack* track = g_hash_table_lookup(self->tracks, id);
+  if(!track) return;
+
+  g_queue_delete_link(&self->lru, track->lru);
+  g_hash_table_remove(self->tracks, id);
+}
+
+static void
+mpris_track_list_forget_all(MprisTrackList* self){
+  g_queue_clear(&self->lru);
+  g_hash_table_remove_all(self->tracks);
+}
+
+/*
+ * Caches the metadata of one track and returns its id, NULL when the
+ * dictionary has none. The least recently shown track is evicted once the
+ * cache is full.
+ */
+static const gchar*
+mpris_track_list_store(MprisTrackList* self, GVariant* metadata){
+  const gchar* id = NULL;
+  if(!g_variant_lookup(metadata, "mpris:trackid", "&o", &id)) return NULL;
+
+  mpris_track_list_forget(self, id);
+
+  MprisTrack* track = g_new0(MprisTrack, 1);
+
+  const gchar* title = NULL;
+  g_variant_lookup(metadata, "xesam:title", "&s", &title);
+  track->title = g_strdup(title ? title : "");
+
+  GVariant* artists = g_variant_lookup_value(metadata, "xesam:artist", G_VARIANT_TYPE_STRING_ARRAY);
+  const gchar* artist = "";
+  if(artists && g_variant_n_children(artists) > 0) g_variant_get_child(artists, 0, "&s", &artist);
+  track->artist = g_strdup(artist);
+  if(artists) g_variant_unref(artists);
+
+  gchar* key = g_strdup(id);
+  g_queue_push_head(&self->lru, key);
+  track->lru = g_queue_peek_head_link(&self->lru);
+  g_hash_table_insert(self->tracks, key, track);
+
+  while(g_hash_table_size(self->tracks) > MPRIS_TRACK_LIST_CACHE_SIZE){
+    mpris_track_list_forget(self, g_queue_peek_tail(&self->lru));
+  }
+
+  return key;
+}
+
+static void
+mpris_track_list_set_ids(MprisTrackList* self, GVariant* tracks){
+  g_ptr_array_set_size(self->ids, 0);
+  mpris_track_list_forget_all(self);
+
+  GVariantIter iter;
+  const gchar* id;
+  g_variant_iter_init(&iter, tracks);
+  while(g_variant_iter_next(&iter, "&o", &id)){
+    g_ptr_array_add(self->ids, g_strdup(id));
+  }
+
+  g_debug("Track list of %s has %u tracks", self->bus_name, self->ids->len);
+  self->changed(self->user_data, MPRIS_TRACK_LIST_RESET, 0, self->ids->len);
+}
+
+static gboolean
+mpris_track_list_find(MprisTrackList* self, const gchar* id, guint* position){
+  return g_ptr_array_find_with_equal_func(self->ids, id, g_str_equal, position);
+}
+
+static void
+on_track_list_signal(GDBusConnection *connection,
+                     const gchar *sender_name,
+                     const gchar *object_path,
+                     const gchar *interface_name,
+                     const gchar *signal_name,
+                     GVariant *parameters,
+                     gpointer user_data){
+  MprisTrackList* self = user_data;
+  MEDIA_WATCHDOG_SCOPE("on_track_list_signal", self->bus_name);
+
+  MEDIA_STATS_INC(MEDIA_STAT_DBUS_SIGNALS);
+
+  if(g_strcmp0(signal_name, "TrackListReplaced") == 0 &&
+     g_variant_is_of_type(parameters, G_VARIANT_TYPE("(aoo)"))){
+    GVariant* tracks = g_variant_get_child_value(parameters, 0);
+    mpris_track_list_set_ids(self, tracks);
+    g_variant_unref(tracks);
+
+  } else if(g_strcmp0(signal_name, "TrackAdded") == 0 &&
+            g_variant_is_of_type(parameters, G_VARIANT_TYPE("(a{sv}o)"))){
+    GVariant* metadata = g_variant_get_child_value(parameters, 0);
+    const gchar* after = NULL;
+    g_variant_get_child(parameters, 1, "&o", &after);
+
+    guint position = 0;
+    if(g_strcmp0(after, MPRIS_TRACK_LIST_NO_TRACK) != 0){
+      if(!mpris_track_list_find(self, after, &position)){
+        g_debug("Track %s added after unknown track %s", self->bus_name, after);
+        position = self->ids->len;
+      } else {
+        position++;
+      }
+    }
+
+    const gchar* id = mpris_track_list_store(self, metadata);
+    if(id){
+      g_ptr_array_insert(self->ids, position, g_strdup(id));
+      self->changed(self->user_data, MPRIS_TRACK_LIST_INSERTED, position, 1);
+    }
+    g_variant_unref(metadata);
+
+  } else if(g_strcmp0(signal_name, "TrackRemoved") == 0 &&
+            g_variant_is_of_type(parameters, G_VARIANT_TYPE("(o)"))){
+    const gchar* id = NULL;
+    g_variant_get(parameters, "(&o)", &id);
+
+    guint position;
+    if(mpris_track_list_find(self, id, &position)){
+      mpris_track_list_forget(self, id);
+      g_ptr_array_remove_index(self->ids, position);
+      self->changed(self->user_data, MPRIS_TRACK_LIST_REMOVED, position, 1);
+    }
+
+  } else if(g_strcmp0(signal_name, "TrackMetadataChanged") == 0 &&
+            g_variant_is_of_type(parameters, G_VARIANT_TYPE("(oa{sv})"))){
+    const gchar* old_id = NULL;
+    g_variant_get_child(parameters, 0, "&o", &old_id);
+
+    guint position;
+    if(mpris_track_list_find(self, old_id, &position)){
+      GVariant* metadata = g_variant_get_child_value(parameters, 1);
+      mpris_track_list_forget(self, old_id);
+
+      // The track id itself may change with its metadata
+      const gchar* id = mpris_track_list_store(self, metadata);
+      if(id && g_strcmp0(id, old_id) != 0){
+        g_free(self->ids->pdata[position]);
+        self->ids->pdata[position] = g_strdup(id);
+      }
+      g_variant_unref(metadata);
+
+      self->changed(self->user_data, MPRIS_TRACK_LIST_LOADED, position, 1);
+    }
+  }
+}
+
+static void
+on_tracks_get_complete(GObject *source_object, GAsyncResult *result, gpointer user_data){
+  GError* error = NULL;
+  GVariant* ret = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source_object), result, &error);
+
+  if(error){
+    if(!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+      g_warning("Can not get the track list: %s", error->message);
+    g_error_free(error);
+    return;
+  }
+
+  MprisTrackList* self = user_data;
+  MEDIA_WATCHDOG_SCOPE("on_tracks_get_complete", self->bus_name);
+
+  GVariant* tracks = NULL;
+  g_variant_get(ret, "(v)", &tracks);
+  if(g_variant_is_of_type(tracks, G_VARIANT_TYPE("ao"))) mpris_track_list_set_ids(self, tracks);
+
+  g_variant_unref(tracks);
+  g_variant_unref(ret);
+}
+
+/*
+ * Watches the TrackList interface of a player. Only the ids are read up
+ * front, metadata is fetched in pages as rows are shown.
+ */
+MprisTrackList*
+mpris_track_list_new(GDBusConnection* conn, const gchar* bus_name,
+                     MprisTrackListChanged changed, gpointer user_data){
+  g_return_val_if_fail(G_IS_DBUS_CONNECTION(conn) && bus_name != NULL && changed != NULL, NULL);
+
+  MprisTrackList* self = g_new0(MprisTrackList, 1);
+  self->conn = g_object_ref(conn);
+  self->bus_name = g_strdup(bus_name);
+  self->cancellable = g_cancellable_new();
+  self->ids = g_ptr_array_new_with_free_func(g_free);
+  self->tracks = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, mpris_track_free);
+  g_queue_init(&self->lru);
+  self->pending = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+  self->changed = changed;
+  self->user_data = user_data;
+
+  self->sub_id = g_dbus_connection_signal_subscribe(
+      self->conn,
+      self->bus_name,
+      IFACE_TRACK_LIST,
+      NULL,
+      MPRIS_PATH,
+      NULL,
+      G_DBUS_SIGNAL_FLAGS_NONE,
+      on_track_list_signal,
+      self,
+      NULL);
+
+  g_dbus_connection_call(self->conn,
+                         self->bus_name,
+                         MPRIS_PATH,
+                         IFACE_PROPS,
+                         "Get",
+                         g_variant_new("(ss)", IFACE_TRACK_LIST, "Tracks"),
+                         G_VARIANT_TYPE("(v)"),
+                         G_DBUS_CALL_FLAGS_NO_AUTO_START,
+                         MPRIS_CALL_TIMEOUT_MS,
+                         self->cancellable,
+                         on_tracks_get_complete,
+                         self);
+
+  return self;
+}
+
+void
+mpris_track_list_free(MprisTrackList* self){
+  if(!self) return;
+
+  // Replies still in flight see the cancellation and leave self alone
+  g_cancellable_cancel(self->cancellable);
+  g_object_unref(self->cancellable);
+
+  g_dbus_connection_signal_unsubscribe(self->conn, self->sub_id);
+  g_object_unref(self->conn);
+
+  g_hash_table_unref(self->pending);
+  mpris_track_list_forget_all(self);
+  g_hash_table_unref(self->tracks);
+  g_ptr_array_unref(self->ids);
+  g_free(self->bus_name);
+  g_free(self);
+}
+
+guint
+mpris_track_list_get_length(MprisTrackList* self){
+  return self->ids->len;
+}
+
+const gchar*
+mpris_track_list_get_id(MprisTrackList* self, guint position){
+  return position < self->ids->len ? g_ptr_array_index(self->ids, position) : NULL;
+}
+
+static void
+mpris_track_page_free(MprisTrackPage* page){
+  g_strfreev(page->ids);
+  g_free(page);
+}
+
+static gint
+mpris_track_position_compare(gconstpointer a, gconstpointer b){
+  guint pa = *(const guint*)a;
+  guint pb = *(const guint*)b;
+  return pa < pb ? -1 : pa > pb;
+}
+
+/*
+ * The list may have been edited while the page was fetched, so the stored
+ * tracks are looked up again and every contiguous run of them is reported
+ * at the position it has now.
+ */
+static void
+mpris_track_list_emit_loaded(MprisTrackList* self, GArray* positions){
+  g_array_sort(positions, mpris_track_position_compare);
+
+  for(guint i = 0; i < positions->len;){
+    guint first = g_array_index(positions, guint, i);
+    guint count = 1;
+
+    while(i + count < positions->len && g_array_index(positions, guint, i + count) == first + count) count++;
+
+    self->changed(self->user_data, MPRIS_TRACK_LIST_LOADED, first, count);
+    i += count;
+  }
+}
+
+static void
+on_tracks_metadata_complete(GObject *source_object, GAsyncResult *result, gpointer user_data){
+  MprisTrackPage* page = user_data;
+  GError* error = NULL;
+  GVariant* ret = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source_object), result, &error);
+
+  if(error && g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)){
+    g_error_free(error);
+    mpris_track_page_free(page);
+    return;
+  }
+
+  MprisTrackList* self = page->list;
+  MEDIA_WATCHDOG_SCOPE("on_tracks_metadata_complete", self->bus_name);
+
+  for(guint i = 0; page->ids[i]; i++){
+    g_hash_table_remove(self->pending, page->ids[i]);
+  }
+
+  if(error){
+    g_warning("Can not get track metadata from %s: %s", self->bus_name, error->message);
+    g_error_free(error);
+  } else {
+    GArray* positions = g_array_new(FALSE, FALSE, sizeof(guint));
+    GVariantIter* iter = NULL;
+    GVariant* metadata;
+    g_variant_get(ret, "(aa{sv})", &iter);
+    while((metadata = g_variant_iter_next_value(iter))){
+      const gchar* id = mpris_track_list_store(self, metadata);
+      guint position;
+
+      if(id && mpris_track_list_find(self, id, &position)) g_array_append_val(positions, position);
+      g_variant_unref(metadata);
+    }
+    g_variant_iter_free(iter);
+    g_variant_unref(ret);
+
+    mpris_track_list_emit_loaded(self, positions);
+    g_array_unref(positions);
+  }
+
+  mpris_track_page_free(page);
+}
+
+/*
+ * Asks for the metadata of the page around position, skipping the tracks
+ * already cached or requested.
+ */
+static void
+mpris_track_list_fetch_page(MprisTrackList* self, guint position){
+  guint first = position - position % MPRIS_TRACK_LIST_PAGE_SIZE;
+  guint last = MIN(first + MPRIS_TRACK_LIST_PAGE_SIZE, self->ids->len);
+
+  GPtrArray* ids = g_ptr_array_new();
+  GVariantBuilder builder;
+  g_variant_builder_init(&builder, G_VARIANT_TYPE("ao"));
+
+  for(guint i = first; i < last; i++){
+    const gchar* id = g_ptr_array_index(self->ids, i);
+    if(g_hash_table_contains(self->tracks, id) || g_hash_table_contains(self->pending, id)) continue;
+
+    g_hash_table_add(self->pending, g_strdup(id));
+    g_ptr_array_add(ids, g_strdup(id));
+    g_variant_builder_add(&builder, "o", id);
+  }
+
+  if(ids->len == 0){
+    g_variant_builder_clear(&builder);
+    g_ptr_array_unref(ids);
+    return;
+  }
+
+  g_ptr_array_add(ids, NULL);
+
+  MprisTrackPage* page = g_new0(MprisTrackPage, 1);
+  page->list = self;
+  page->ids = (gchar**)g_ptr_array_free(ids, FALSE);
+
+  g_debug("Fetching metadata of tracks %u-%u from %s", first, last, self->bus_name);
+
+  g_dbus_connection_call(self->conn,
+                         self->bus_name,
+                         MPRIS_PATH,
+                         IFACE_TRACK_LIST,
+                         "GetTracksMetadata",
+                         g_variant_new("(ao)", &builder),
+                         G_VARIANT_TYPE("(aa{sv})"),
+                         G_DBUS_CALL_FLAGS_NO_AUTO_START,
+                         MPRIS_CALL_TIMEOUT_MS,
+                         self->cancellable,
+                         on_tracks_metadata_complete,
+                         page);
+}
+
+/*
+ * Returns TRUE with borrowed strings when the track is cached. Otherwise
+ * its page is requested and MPRIS_TRACK_LIST_LOADED follows.
+ */
+gboolean
+mpris_track_list_get_metadata(MprisTrackList* self, guint position,
+                              const gchar** title, const gchar** artist){
+  const gchar* id = mpris_track_list_get_id(self, position);
+  if(!id) return FALSE;
+
+  MprisTrack* track = g_hash_table_lookup(self->tracks, id);
+  if(!track){
+    if(!g_hash_table_contains(self->pending, id)) mpris_track_list_fetch_page(self, position);
+    return FALSE;
+  }
+
+  g_queue_unlink(&self->lru, track->lru);
+  g_queue_push_head_link(&self->lru, track->lru);
+
+  *title = track->title;
+  *artist = track->artist;
+  return TRUE;
+}
+
+static void
+on_go_to_complete(GObject *source_object, GAsyncResult *result, gpointer user_data){
+  GError* error = NULL;
+  GVariant* ret = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source_object), result, &error);
+
+  if(error){
+    if(!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+      g_warning("GoTo failed: %s", error->message);
+    g_error_free(error);
+    return;
+  }
+
+  g_variant_unref(ret);
+}
+
+void
+mpris_track_list_go_to(MprisTrackList* self, guint position){
+  const gchar* id = mpris_track_list_get_id(self, position);
+  if(!id) return;
+
+  g_dbus_connection_call(self->conn,
+                         self->bus_name,
+                         MPRIS_PATH,
+                         IFACE_TRACK_LIST,
+                         "GoTo",
+                         g_variant_new("(o)", id),
+                         NULL,
+                         G_DBUS_CALL_FLAGS_NO_AUTO_START,
+                         MPRIS_CALL_TIMEOUT_MS,
+                         // The list is usually closed right after, keep the call alive
+                         NULL,
+                         on_go_to_complete,
+                         NULL);
+}
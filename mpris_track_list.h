@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <glib.h>
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define IFACE_TRACK_LIST              "org.mpris.MediaPlayer2.TrackList"
+#define MPRIS_TRACK_LIST_NO_TRACK     "/org/mpris/MediaPlayer2/TrackList/NoTrack"
+
+// Tracks fetched per GetTracksMetadata call and tracks kept in the cache
+#define MPRIS_TRACK_LIST_PAGE_SIZE    50
+#define MPRIS_TRACK_LIST_CACHE_SIZE   500
+
+typedef enum _MprisTrackListChange
+{
+  // Every track changed, count is the new length
+  MPRIS_TRACK_LIST_RESET,
+  MPRIS_TRACK_LIST_INSERTED,
+  MPRIS_TRACK_LIST_REMOVED,
+  // Metadata arrived for tracks already in the list
+  MPRIS_TRACK_LIST_LOADED,
+} MprisTrackListChange;
+
+typedef void (*MprisTrackListChanged)(gpointer user_data,
+                                      MprisTrackListChange change,
+                                      guint position,
+                                      guint count);
+
+typedef struct _MprisTrackList MprisTrackList;
+
+MprisTrackList* mpris_track_list_new(GDBusConnection* conn, const gchar* bus_name,
+                                     MprisTrackListChanged changed, gpointer user_data);
+void mpris_track_list_free(MprisTrackList* self);
+
+guint mpris_track_list_get_length(MprisTrackList* self);
+const gchar* mpris_track_list_get_id(MprisTrackList* self, guint position);
+gboolean mpris_track_list_get_metadata(MprisTrackList* self, guint position,
+                                       const gchar** title, const gchar** artist);
+void mpris_track_list_go_to(MprisTrackList* self, guint position);
+
+G_END_DECLS
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <gtk/gtk.h>
+#include <cairo.h>
+
+#include "harness.h"
+#include "module_host.h"
+#include "mock_player.h"
+
+/*
+ * Cost of drawing the module into a cairo image surface, the way a frame
+ * is painted, with a playing player and the time label on. Needs a
+ * display, exits with 77 (skipped) without one:
+ *
+ *   bench_draw --frames=2000
+ */
+
+#define BENCH_SKIP 77
+
+int
+main(int argc, char** argv){
+  gint frames = 2000;
+
+  GOptionEntry entries[] = {
+    { "frames", 0, 0, G_OPTION_ARG_INT, &frames, "Frames to draw", "N" },
+    { NULL }
+  };
+
+  GError* error = NULL;
+  GOptionContext* context = g_option_context_new("- offscreen draw cost");
+  g_option_context_add_main_entries(context, entries, NULL);
+  if(!g_option_context_parse(context, &argc, &argv, &error)){
+    g_printerr("%s\n", error->message);
+    return 1;
+  }
+  g_option_context_free(context);
+
+  if(!module_host_init(&argc, &argv)){
+    g_printerr("No display, skipping\n");
+    return BENCH_SKIP;
+  }
+
+  Harness harness;
+  harness_up(&harness);
+
+  MockPlayerConfig config = { .playing = TRUE, .title = "Song" };
+  MockPlayer* mock = mock_player_new(harness_get_address(&harness), 0, &config);
+
+  static const wbcffi_config_entry entries_config[] = {
+    { "time-format", "\"elapsed\"" },
+  };
+
+  ModuleHost host;
+  module_host_load(&host, entries_config, G_N_ELEMENTS(entries_config));
+
+  // Let the module collect the player and lay itself out
+  harness_run_for(1500);
+
+  GtkAllocation allocation;
+  gtk_widget_get_allocation(host.root, &allocation);
+
+  cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                                        MAX(allocation.width, 1), MAX(allocation.height, 1));
+  cairo_t* cr = cairo_create(surface);
+
+  gint64 start = g_get_monotonic_time();
+  for(gint i = 0; i < frames; i++){
+    cairo_save(cr);
+    gtk_widget_draw(host.root, cr);
+    cairo_restore(cr);
+  }
+  cairo_surface_flush(surface);
+  gint64 elapsed = g_get_monotonic_time() - start;
+
+  g_print("size=%dx%d frames=%d us/frame=%.1f\n",
+          allocation.width, allocation.height, frames, elapsed / (gdouble)MAX(frames, 1));
+
+  cairo_destroy(cr);
+  cairo_surface_destroy(surface);
+
+  module_host_unload(&host);
+  mock_player_free(mock);
+  harness_down(&harness);
+
+  return 0;
+}
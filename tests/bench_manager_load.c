@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#include "harness.h"
+#include "mock_player.h"
+#include "mpris_media_manager.h"
+#include "mpris_media_player.h"
+#include "media_stats.h"
+
+/*
+ * Load of the manager under a fleet of busy players. The fleet runs in its
+ * own process, so CPU time and memory are the manager's alone:
+ *
+ *   bench_manager_load --players=50 --metadata-rate=2 --seeked-rate=1
+ */
+
+typedef struct
+{
+  GPtrArray* players;
+  gboolean ready;
+} Bench;
+
+static void
+on_player_added(GMprisMediaManager* manager, GMprisMediaPlayer* player, gpointer user_data){
+  Bench* bench = user_data;
+  g_ptr_array_add(bench->players, player);
+}
+
+static void
+on_player_removed(GMprisMediaManager* manager, GMprisMediaPlayer* player, gpointer user_data){
+  Bench* bench = user_data;
+  g_ptr_array_remove(bench->players, player);
+}
+
+static void
+on_ready(GMprisMediaManager* manager, gpointer user_data){
+  Bench* bench = user_data;
+  bench->ready = TRUE;
+}
+
+int
+main(int argc, char** argv){
+  gint players = 20;
+  gint seconds = 5;
+  MockPlayerConfig config = {
+    .metadata_rate = 2,
+    .seeked_rate = 1,
+    .status_rate = 0.5,
+    .playing = TRUE,
+  };
+  gint latency = 0;
+
+  GOptionEntry entries[] = {
+    { "players", 0, 0, G_OPTION_ARG_INT, &players, "Number of mock players", "N" },
+    { "seconds", 0, 0, G_OPTION_ARG_INT, &seconds, "Length of the measured window", "S" },
+    { "metadata-rate", 0, 0, G_OPTION_ARG_DOUBLE, &config.metadata_rate, "Track changes per player and second", "RATE" },
+    { "seeked-rate", 0, 0, G_OPTION_ARG_DOUBLE, &config.seeked_rate, "Seeked signals per player and second", "RATE" },
+    { "status-rate", 0, 0, G_OPTION_ARG_DOUBLE, &config.status_rate, "PlaybackStatus flips per player and second", "RATE" },
+    { "latency", 0, 0, G_OPTION_ARG_INT, &latency, "Delay of every reply", "MS" },
+    { NULL }
+  };
+
+  GError* error = NULL;
+  GOptionContext* context = g_option_context_new("- manager load under mock players");
+  g_option_context_add_main_entries(context, entries, NULL);
+  if(!g_option_context_parse(context, &argc, &argv, &error)){
+    g_printerr("%s\n", error->message);
+    return 1;
+  }
+  g_option_context_free(context);
+  config.latency_ms = MAX(latency, 0);
+
+  Harness harness;
+  harness_up(&harness);
+  if(!harness_spawn_fleet(&harness, players, &config)){
+    harness_down(&harness);
+    return 1;
+  }
+
+  Bench bench = { g_ptr_array_new(), FALSE };
+  GMprisMediaManager* manager = g_mpris_media_manager_new_for_connection(harness.conn);
+  g_signal_connect(manager, "player-added", G_CALLBACK(on_player_added), &bench);
+  g_signal_connect(manager, "player-removed", G_CALLBACK(on_player_removed), &bench);
+  g_signal_connect(manager, "ready", G_CALLBACK(on_ready), &bench);
+
+  gint64 start = g_get_monotonic_time();
+  g_mpris_media_manager_start(manager);
+  if(!harness_wait_for(&bench.ready, 30000)){
+    g_printerr("Manager never got ready\n");
+    return 1;
+  }
+  gdouble startup_ms = (g_get_monotonic_time() - start) / 1000.0;
+
+  guint64 signals = media_stats[MEDIA_STAT_DBUS_SIGNALS];
+  guint64 updates = media_stats[MEDIA_STAT_UPDATE_INFO];
+  gdouble cpu = harness_get_cpu_time();
+  start = g_get_monotonic_time();
+
+  harness_run_for(seconds * 1000);
+
+  gdouble wall = (g_get_monotonic_time() - start) / (gdouble)G_USEC_PER_SEC;
+  cpu = harness_get_cpu_time() - cpu;
+  signals = media_stats[MEDIA_STAT_DBUS_SIGNALS] - signals;
+  updates = media_stats[MEDIA_STAT_UPDATE_INFO] - updates;
+
+  gsize memory = 0;
+  for(guint i = 0; i < bench.players->len; i++){
+    memory += g_mpris_media_player_get_memory(g_ptr_array_index(bench.players, i), NULL);
+  }
+
+  g_print("players=%u startup=%.1fms window=%.1fs\n", bench.players->len, startup_ms, wall);
+  g_print("events=%" G_GUINT64_FORMAT " events/s=%.1f updates/s=%.1f\n",
+          signals, signals / wall, updates / wall);
+  g_print("cpu=%.1f%% cpu/event=%.1fus\n",
+          cpu * 100.0 / wall, signals ? cpu * G_USEC_PER_SEC / signals : 0.0);
+  g_print("memory/player=%" G_GSIZE_FORMAT "B rss=%" G_GSIZE_FORMAT "KiB peak-rss=%" G_GSIZE_FORMAT "KiB\n",
+          bench.players->len ? memory / bench.players->len : 0,
+          harness_get_rss() / 1024, harness_get_peak_rss() / 1024);
+
+  g_signal_handlers_disconnect_by_data(manager, &bench);
+  g_object_unref(manager);
+  g_ptr_array_unref(bench.players);
+  harness_down(&harness);
+
+  return 0;
+}
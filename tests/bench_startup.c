@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <gtk/gtk.h>
+#include <stdlib.h>
+
+#include "harness.h"
+#include "module_host.h"
+#include "mock_player.h"
+#include "mpris_media_manager.h"
+#include "media_timeline.h"
+
+/*
+ * Startup timeline percentiles with a fleet of mock players on the bus:
+ *
+ *   bench_startup --players=10 --runs=50 --latency=5
+ *
+ * The manager phases (bus, ListNames, players ready) are always measured.
+ * With a display the whole module is loaded as well, from wbcffi_init to
+ * the first draw. Runs after the first paint from the snapshot the one
+ * before left, like a bar started again at login.
+ */
+
+typedef struct
+{
+  // Milliseconds per run, indexed by MediaTimelinePhase
+  GArray* phases[MEDIA_TIMELINE_LAST];
+} Samples;
+
+static gint
+compare_double(gconstpointer a, gconstpointer b){
+  gdouble da = *(const gdouble*)a;
+  gdouble db = *(const gdouble*)b;
+  return da < db ? -1 : da > db;
+}
+
+static gdouble
+percentile(GArray* sorted, guint p){
+  guint index = (sorted->len * p + 99) / 100;
+  return g_array_index(sorted, gdouble, MAX(index, 1) - 1);
+}
+
+static void
+samples_init(Samples* samples){
+  for(guint i = 0; i < MEDIA_TIMELINE_LAST; i++){
+    samples->phases[i] = g_array_new(FALSE, FALSE, sizeof(gdouble));
+  }
+}
+
+static void
+samples_add_run(Samples* samples){
+  for(guint i = 0; i < MEDIA_TIMELINE_LAST; i++){
+    gint64 phase = media_timeline_get_phase(i);
+    if(!phase) continue;
+
+    gdouble ms = phase / 1000.0;
+    g_array_append_val(samples->phases[i], ms);
+  }
+}
+
+static void
+samples_print(Samples* samples, const gchar* mode, guint runs){
+  g_print("%s, %u runs (ms since start)\n", mode, runs);
+
+  for(guint i = 0; i < MEDIA_TIMELINE_LAST; i++){
+    GArray* values = samples->phases[i];
+    if(values->len == 0) continue;
+
+    g_array_sort(values, compare_double);
+    g_print("  %-14s p50=%7.2f p90=%7.2f p99=%7.2f max=%7.2f\n",
+            media_timeline_get_phase_name(i),
+            percentile(values, 50), percentile(values, 90), percentile(values, 99),
+            g_array_index(values, gdouble, values->len - 1));
+  }
+}
+
+static void
+samples_clear(Samples* samples){
+  for(guint i = 0; i < MEDIA_TIMELINE_LAST; i++) g_array_unref(samples->phases[i]);
+}
+
+static void
+on_ready(GMprisMediaManager* manager, gpointer user_data){
+  *(gboolean*)user_data = TRUE;
+}
+
+static gboolean
+run_manager(Harness* harness){
+  gboolean ready = FALSE;
+
+  media_timeline_begin();
+
+  GMprisMediaManager* manager = g_mpris_media_manager_new_for_connection(harness->conn);
+  g_signal_connect(manager, "ready", G_CALLBACK(on_ready), &ready);
+  g_mpris_media_manager_start(manager);
+
+  harness_wait_for(&ready, 30000);
+  media_timeline_finish();
+  g_object_unref(manager);
+
+  // Let the cancelled calls of this run drain before the next one
+  harness_run_for(50);
+  return ready;
+}
+
+static gboolean
+run_module(void){
+  ModuleHost host;
+  gint64 deadline = g_get_monotonic_time() + 30 * G_USEC_PER_SEC;
+
+  module_host_load(&host, NULL, 0);
+
+  // The module finishes the timeline with its first live draw
+  while(!media_timeline_is_finished() && g_get_monotonic_time() < deadline) harness_run_for(5);
+  gboolean finished = media_timeline_is_finished();
+
+  module_host_unload(&host);
+  harness_run_for(50);
+  return finished;
+}
+
+int
+main(int argc, char** argv){
+  gint players = 10;
+  gint runs = 50;
+  gint latency = 0;
+
+  GOptionEntry entries[] = {
+    { "players", 0, 0, G_OPTION_ARG_INT, &players, "Number of mock players", "N" },
+    { "runs", 0, 0, G_OPTION_ARG_INT, &runs, "Measured startups per mode", "N" },
+    { "latency", 0, 0, G_OPTION_ARG_INT, &latency, "Delay of every reply", "MS" },
+    { NULL }
+  };
+
+  GError* error = NULL;
+  GOptionContext* context = g_option_context_new("- startup timeline percentiles");
+  g_option_context_add_main_entries(context, entries, NULL);
+  if(!g_option_context_parse(context, &argc, &argv, &error)){
+    g_printerr("%s\n", error->message);
+    return 1;
+  }
+  g_option_context_free(context);
+
+  // Keep the snapshot away from the real one
+  gchar* runtime_dir = g_dir_make_tmp("bench_startup-XXXXXX", NULL);
+  g_setenv("XDG_RUNTIME_DIR", runtime_dir, TRUE);
+
+  gboolean display = module_host_init(&argc, &argv);
+
+  Harness harness;
+  harness_up(&harness);
+
+  MockPlayerConfig config = { .playing = TRUE, .latency_ms = MAX(latency, 0) };
+  if(!harness_spawn_fleet(&harness, players, &config)){
+    harness_down(&harness);
+    return 1;
+  }
+
+  g_print("players=%d latency=%dms\n", players, latency);
+
+  Samples samples;
+  samples_init(&samples);
+  for(gint i = 0; i < runs; i++){
+    if(run_manager(&harness)) samples_add_run(&samples);
+  }
+  samples_print(&samples, "manager", runs);
+  samples_clear(&samples);
+
+  if(display){
+    samples_init(&samples);
+    for(gint i = 0; i < runs; i++){
+      if(run_module()) samples_add_run(&samples);
+    }
+    samples_print(&samples, "module", runs);
+    samples_clear(&samples);
+  } else {
+    g_print("module: no display, skipped\n");
+  }
+
+  harness_down(&harness);
+
+  gchar* snapshot = g_build_filename(runtime_dir, "waybar_mediaplayer-0.snapshot", NULL);
+  g_remove(snapshot);
+  g_free(snapshot);
+  g_rmdir(runtime_dir);
+  g_free(runtime_dir);
+
+  return 0;
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <pango/pangocairo.h>
+
+#include "media_title_format.h"
+#include "media_title_style.h"
+
+/*
+ * Styled title on a burst of track changes, no display needed. Compares
+ * escaping every field into Pango markup and parsing it again against
+ * rendering the template and reusing the cached attribute list:
+ *
+ *   bench_title_attrs --tracks=100000
+ *
+ * "prepare" is the cost up to the text and attributes, "layout" adds
+ * handing them to a PangoLayout and measuring it like the label does.
+ */
+
+#define STYLE_ARTIST "weight='bold'"
+#define STYLE_TITLE  "foreground='#e0af68'"
+
+// Artists of two lengths, so the title span moves on some changes
+static const gchar* artists[] = { "Artist", "Artist", "Other & Artist" };
+
+typedef struct
+{
+  const gchar* name;
+  gboolean layout;
+} Scenario;
+
+static void
+track_values(const gchar* values[MEDIA_TITLE_FIELD_LAST], gchar* title, gsize title_size, guint i){
+  for(guint f = 0; f < MEDIA_TITLE_FIELD_LAST; f++) values[f] = NULL;
+
+  g_snprintf(title, title_size, "Track %u <live> & more", i % 1000);
+  values[MEDIA_TITLE_FIELD_ARTIST] = artists[i % G_N_ELEMENTS(artists)];
+  values[MEDIA_TITLE_FIELD_TITLE] = title;
+}
+
+static gdouble
+run_markup(PangoLayout* layout, gboolean measure, guint tracks){
+  const gchar* values[MEDIA_TITLE_FIELD_LAST];
+  gchar title[64];
+
+  gint64 start = g_get_monotonic_time();
+  for(guint i = 0; i < tracks; i++){
+    track_values(values, title, sizeof(title), i);
+
+    gchar* markup = g_markup_printf_escaped("<span " STYLE_ARTIST ">%s</span> - <span " STYLE_TITLE ">%s</span>",
+                                            values[MEDIA_TITLE_FIELD_ARTIST], values[MEDIA_TITLE_FIELD_TITLE]);
+    if(measure){
+      pango_layout_set_markup(layout, markup, -1);
+      pango_layout_get_size(layout, NULL, NULL);
+    } else {
+      PangoAttrList* attrs = NULL;
+      pango_parse_markup(markup, -1, 0, &attrs, NULL, NULL, NULL);
+      pango_attr_list_unref(attrs);
+    }
+    g_free(markup);
+  }
+  return (g_get_monotonic_time() - start) * 1000.0 / MAX(tracks, 1);
+}
+
+static gdouble
+run_attrs(PangoLayout* layout, gboolean measure, guint tracks, guint* rebuilt){
+  gchar* styles[MEDIA_TITLE_FIELD_LAST] = { 0 };
+  styles[MEDIA_TITLE_FIELD_ARTIST] = STYLE_ARTIST;
+  styles[MEDIA_TITLE_FIELD_TITLE] = STYLE_TITLE;
+
+  MediaTitleFormat* format = media_title_format_compile(MEDIA_TITLE_FORMAT_DEFAULT);
+  MediaTitleStyle* style = media_title_style_new(styles);
+  GString* text = g_string_new(NULL);
+  MediaTitleSpan spans[MEDIA_TITLE_FIELD_LAST];
+  const gchar* values[MEDIA_TITLE_FIELD_LAST];
+  gchar title[64];
+
+  *rebuilt = 0;
+
+  gint64 start = g_get_monotonic_time();
+  for(guint i = 0; i < tracks; i++){
+    track_values(values, title, sizeof(title), i);
+    media_title_format_render(format, values, text, spans);
+
+    gboolean changed;
+    PangoAttrList* attrs = media_title_style_get_attrs(style, spans, &changed);
+    if(changed) (*rebuilt)++;
+
+    if(measure){
+      pango_layout_set_text(layout, text->str, text->len);
+      if(changed) pango_layout_set_attributes(layout, attrs);
+      pango_layout_get_size(layout, NULL, NULL);
+    }
+  }
+  gdouble ns = (g_get_monotonic_time() - start) * 1000.0 / MAX(tracks, 1);
+
+  g_string_free(text, TRUE);
+  media_title_style_free(style);
+  media_title_format_free(format);
+  return ns;
+}
+
+int
+main(int argc, char** argv){
+  gint tracks = 100000;
+
+  GOptionEntry entries[] = {
+    { "tracks", 0, 0, G_OPTION_ARG_INT, &tracks, "Track changes per scenario", "N" },
+    { NULL }
+  };
+
+  GError* error = NULL;
+  GOptionContext* context = g_option_context_new("- styled title markup against cached attributes");
+  g_option_context_add_main_entries(context, entries, NULL);
+  if(!g_option_context_parse(context, &argc, &argv, &error)){
+    g_printerr("%s\n", error->message);
+    return 1;
+  }
+  g_option_context_free(context);
+
+  static const Scenario scenarios[] = {
+    { "prepare", FALSE },
+    { "layout", TRUE },
+  };
+
+  PangoContext* pango = pango_font_map_create_context(pango_cairo_font_map_get_default());
+
+  for(guint s = 0; s < G_N_ELEMENTS(scenarios); s++){
+    PangoLayout* layout = pango_layout_new(pango);
+    gdouble markup = run_markup(layout, scenarios[s].layout, MAX(tracks, 0));
+    g_object_unref(layout);
+
+    layout = pango_layout_new(pango);
+    guint rebuilt;
+    gdouble attrs = run_attrs(layout, scenarios[s].layout, MAX(tracks, 0), &rebuilt);
+    g_object_unref(layout);
+
+    g_print("%-8s tracks=%d markup ns/update=%.1f attrs ns/update=%.1f rebuilt=%u (%.2fx)\n",
+            scenarios[s].name, tracks, markup, attrs, rebuilt, markup / MAX(attrs, 0.1));
+  }
+
+  g_object_unref(pango);
+  return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <string.h>
+
+#include "media_view_model.h"
+
+/*
+ * Cost of one view model update, no display needed. Every scenario feeds
+ * the same model a stream of inputs the way the controller does:
+ *
+ *   bench_view_model --updates=1000000
+ */
+
+typedef struct
+{
+  const gchar* name;
+  // Fills input for update i
+  void (*next)(MediaViewInput* input, guint i);
+} Scenario;
+
+static const gchar* titles[] = { "Song", "Another Song With A Longer Name" };
+
+static void
+base_input(MediaViewInput* input){
+  memset(input, 0, sizeof(MediaViewInput));
+  input->player_pos = 1;
+  input->player_count = 2;
+  input->fields[MEDIA_TITLE_FIELD_ARTIST] = "Artist";
+  input->fields[MEDIA_TITLE_FIELD_TITLE] = titles[0];
+  input->playing = TRUE;
+  input->has_progress = TRUE;
+  input->can_go_previous = TRUE;
+  input->can_go_next = TRUE;
+  input->length = 180 * G_USEC_PER_SEC;
+}
+
+// Nothing changes, the early outs are measured
+static void
+next_steady(MediaViewInput* input, guint i){
+  base_input(input);
+}
+
+// A playing track, the position moves 250ms per update
+static void
+next_progress(MediaViewInput* input, guint i){
+  base_input(input);
+  input->position = ((gint64)i * 250 * G_TIME_SPAN_MILLISECOND) % input->length;
+}
+
+// Every update is another track
+static void
+next_title(MediaViewInput* input, guint i){
+  base_input(input);
+  input->fields[MEDIA_TITLE_FIELD_TITLE] = titles[i % 2];
+}
+
+// Cycling through players with their own state
+static void
+next_switch(MediaViewInput* input, guint i){
+  base_input(input);
+  input->player_pos = i % 2 + 1;
+  input->fields[MEDIA_TITLE_FIELD_TITLE] = titles[i % 2];
+  input->playing = i % 2 == 0;
+  input->can_go_previous = i % 2 == 0;
+}
+
+int
+main(int argc, char** argv){
+  gint updates = 1000000;
+
+  GOptionEntry entries[] = {
+    { "updates", 0, 0, G_OPTION_ARG_INT, &updates, "Updates per scenario", "N" },
+    { NULL }
+  };
+
+  GError* error = NULL;
+  GOptionContext* context = g_option_context_new("- view model update cost");
+  g_option_context_add_main_entries(context, entries, NULL);
+  if(!g_option_context_parse(context, &argc, &argv, &error)){
+    g_printerr("%s\n", error->message);
+    return 1;
+  }
+  g_option_context_free(context);
+
+  static const Scenario scenarios[] = {
+    { "steady", next_steady },
+    { "progress", next_progress },
+    { "title", next_title },
+    { "switch", next_switch },
+  };
+
+  MediaTitleFormat* format = media_title_format_compile(MEDIA_TITLE_FORMAT_DEFAULT);
+
+  for(guint s = 0; s < G_N_ELEMENTS(scenarios); s++){
+    MediaViewModel view;
+    MediaViewInput input;
+    guint64 changed = 0;
+
+    media_view_model_init(&view, format);
+
+    gint64 start = g_get_monotonic_time();
+    for(gint i = 0; i < updates; i++){
+      scenarios[s].next(&input, i);
+      if(media_view_model_update(&view, &input)) changed++;
+    }
+    gint64 elapsed = g_get_monotonic_time() - start;
+
+    g_print("%-10s updates=%d changed=%" G_GUINT64_FORMAT " ns/update=%.1f\n",
+            scenarios[s].name, updates, changed, elapsed * 1000.0 / MAX(updates, 1));
+
+    media_view_model_clear(&view);
+  }
+
+  media_title_format_free(format);
+  return 0;
+}
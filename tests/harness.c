@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define G_LOG_DOMAIN "waybarmediaplayer.harness"
+
+#include <glib.h>
+#include <gio/gio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include "harness.h"
+
+/*
+ * Starts a dbus-daemon of its own. GTestDBus also points the session bus
+ * address at it, so code that asks for the session bus lands there too.
+ */
+void
+harness_up(Harness* self){
+  memset(self, 0, sizeof(Harness));
+
+  self->bus = g_test_dbus_new(G_TEST_DBUS_NONE);
+  g_test_dbus_up(self->bus);
+
+  GError* error = NULL;
+  self->conn = g_dbus_connection_new_for_address_sync(harness_get_address(self),
+      G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT | G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION,
+      NULL, NULL, &error);
+  if(!self->conn) g_error("Can not connect to the test bus: %s", error->message);
+}
+
+void
+harness_down(Harness* self){
+  harness_stop_fleet(self);
+
+  if(self->conn){
+    g_dbus_connection_close_sync(self->conn, NULL, NULL);
+    g_clear_object(&self->conn);
+  }
+
+  if(self->bus){
+    g_test_dbus_down(self->bus);
+    g_clear_object(&self->bus);
+  }
+}
+
+const gchar*
+harness_get_address(Harness* self){
+  return g_test_dbus_get_bus_address(self->bus);
+}
+
+/*
+ * Starts that many mock players in a mock_fleet process, found through the
+ * MOCK_FLEET environment variable the build sets. Returns once every name
+ * is owned.
+ */
+gboolean
+harness_spawn_fleet(Harness* self, guint players, const MockPlayerConfig* config){
+  const gchar* fleet = g_getenv("MOCK_FLEET");
+  if(!fleet){
+    g_warning("MOCK_FLEET is not set, run through meson test or meson test --benchmark");
+    return FALSE;
+  }
+
+  GPtrArray* argv = g_ptr_array_new_with_free_func(g_free);
+  g_ptr_array_add(argv, g_strdup(fleet));
+  g_ptr_array_add(argv, g_strdup_printf("--address=%s", harness_get_address(self)));
+  g_ptr_array_add(argv, g_strdup_printf("--players=%u", players));
+  g_ptr_array_add(argv, g_strdup_printf("--metadata-rate=%g", config->metadata_rate));
+  g_ptr_array_add(argv, g_strdup_printf("--seeked-rate=%g", config->seeked_rate));
+  g_ptr_array_add(argv, g_strdup_printf("--status-rate=%g", config->status_rate));
+  g_ptr_array_add(argv, g_strdup_printf("--latency=%u", config->latency_ms));
+  if(config->playing) g_ptr_array_add(argv, g_strdup("--playing"));
+  if(config->title) g_ptr_array_add(argv, g_strdup_printf("--title=%s", config->title));
+  g_ptr_array_add(argv, NULL);
+
+  GError* error = NULL;
+  self->fleet = g_subprocess_newv((const gchar* const*)argv->pdata,
+                                  G_SUBPROCESS_FLAGS_STDIN_PIPE | G_SUBPROCESS_FLAGS_STDOUT_PIPE,
+                                  &error);
+  g_ptr_array_unref(argv);
+
+  if(!self->fleet){
+    g_warning("Can not start %s: %s", fleet, error->message);
+    g_error_free(error);
+    return FALSE;
+  }
+
+  // The fleet prints one line once all of its names are owned
+  GDataInputStream* out = g_data_input_stream_new(g_subprocess_get_stdout_pipe(self->fleet));
+  gchar* line = g_data_input_stream_read_line(out, NULL, NULL, &error);
+  g_object_unref(out);
+
+  gboolean ready = g_strcmp0(line, "ready") == 0;
+  if(!ready){
+    g_warning("Mock fleet did not start: %s", error ? error->message : (line ? line : "EOF"));
+    g_clear_error(&error);
+    harness_stop_fleet(self);
+  }
+
+  g_free(line);
+  return ready;
+}
+
+// Closing its stdin makes the fleet drop its players and exit
+void
+harness_stop_fleet(Harness* self){
+  if(!self->fleet) return;
+
+  g_output_stream_close(g_subprocess_get_stdin_pipe(self->fleet), NULL, NULL);
+  g_subprocess_wait(self->fleet, NULL, NULL);
+  g_clear_object(&self->fleet);
+}
+
+static gboolean
+harness_timeout_callback(gpointer user_data){
+  *(gboolean*)user_data = TRUE;
+  return G_SOURCE_REMOVE;
+}
+
+gboolean
+harness_wait_for(gboolean* flag, guint timeout_ms){
+  gboolean timed_out = FALSE;
+  guint source = g_timeout_add(timeout_ms, harness_timeout_callback, &timed_out);
+
+  while(!*flag && !timed_out) g_main_context_iteration(NULL, TRUE);
+
+  if(!timed_out) g_source_remove(source);
+  return *flag;
+}
+
+void
+harness_run_for(guint ms){
+  gboolean done = FALSE;
+  g_timeout_add(ms, harness_timeout_callback, &done);
+
+  while(!done) g_main_context_iteration(NULL, TRUE);
+}
+
+// Resident set in bytes right now
+gsize
+harness_get_rss(void){
+  gchar* contents = NULL;
+  if(!g_file_get_contents("/proc/self/statm", &contents, NULL, NULL)) return 0;
+
+  gchar** fields = g_strsplit(contents, " ", 3);
+  gsize rss = fields[0] && fields[1] ? g_ascii_strtoull(fields[1], NULL, 10) * sysconf(_SC_PAGESIZE) : 0;
+
+  g_strfreev(fields);
+  g_free(contents);
+  return rss;
+}
+
+// Highest resident set in bytes since the process started
+gsize
+harness_get_peak_rss(void){
+  struct rusage usage;
+  if(getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+
+  return (gsize)usage.ru_maxrss * 1024;
+}
+
+// User and system time of this process in seconds
+gdouble
+harness_get_cpu_time(void){
+  struct rusage usage;
+  if(getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / (gdouble)G_USEC_PER_SEC;
+}
+
+guint
+harness_count_fds(void){
+  GDir* dir = g_dir_open("/proc/self/fd", 0, NULL);
+  if(!dir) return 0;
+
+  guint count = 0;
+  while(g_dir_read_name(dir)) count++;
+  g_dir_close(dir);
+
+  // The directory itself was open while it was read
+  return count - 1;
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#include "mock_player.h"
+
+G_BEGIN_DECLS
+
+/*
+ * A private bus for one test or benchmark run. Mock players either live in
+ * the process (mock_player_new on harness_get_address) or in a mock_fleet
+ * child, which keeps their CPU time and memory out of the readings.
+ */
+typedef struct _Harness
+{
+  GTestDBus* bus;
+  // Connection the code under test watches players on
+  GDBusConnection* conn;
+  GSubprocess* fleet;
+} Harness;
+
+void harness_up(Harness* self);
+void harness_down(Harness* self);
+const gchar* harness_get_address(Harness* self);
+
+gboolean harness_spawn_fleet(Harness* self, guint players, const MockPlayerConfig* config);
+void harness_stop_fleet(Harness* self);
+
+// Runs the default main context until *flag is set or timeout_ms passed
+gboolean harness_wait_for(gboolean* flag, guint timeout_ms);
+// Runs the default main context for ms
+void harness_run_for(guint ms);
+
+gsize harness_get_rss(void);
+gsize harness_get_peak_rss(void);
+gdouble harness_get_cpu_time(void);
+guint harness_count_fds(void);
+
+G_END_DECLS
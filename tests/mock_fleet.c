@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define G_LOG_DOMAIN "waybarmediaplayer.mock-fleet"
+
+#include <glib.h>
+#include <glib-unix.h>
+#include <gio/gio.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "mock_player.h"
+
+/*
+ * Hosts mock players for benchmarks that must not pay for them. Prints
+ * "ready" once every name is owned and exits when its stdin is closed.
+ */
+
+static gboolean
+on_stdin(gint fd, GIOCondition condition, gpointer user_data){
+  gchar buffer[64];
+
+  if((condition & G_IO_IN) && read(fd, buffer, sizeof(buffer)) > 0) return G_SOURCE_CONTINUE;
+
+  g_main_loop_quit(user_data);
+  return G_SOURCE_REMOVE;
+}
+
+int
+main(int argc, char** argv){
+  gchar* address = NULL;
+  gint players = 1;
+  gdouble metadata_rate = 0;
+  gdouble seeked_rate = 0;
+  gdouble status_rate = 0;
+  gint latency = 0;
+  gboolean playing = FALSE;
+  gchar* title = NULL;
+
+  GOptionEntry entries[] = {
+    { "address", 0, 0, G_OPTION_ARG_STRING, &address, "Bus to serve the players on", "ADDRESS" },
+    { "players", 0, 0, G_OPTION_ARG_INT, &players, "Number of players", "N" },
+    { "metadata-rate", 0, 0, G_OPTION_ARG_DOUBLE, &metadata_rate, "Track changes per second", "RATE" },
+    { "seeked-rate", 0, 0, G_OPTION_ARG_DOUBLE, &seeked_rate, "Seeked signals per second", "RATE" },
+    { "status-rate", 0, 0, G_OPTION_ARG_DOUBLE, &status_rate, "PlaybackStatus flips per second", "RATE" },
+    { "latency", 0, 0, G_OPTION_ARG_INT, &latency, "Delay of every reply", "MS" },
+    { "playing", 0, 0, G_OPTION_ARG_NONE, &playing, "Start playing", NULL },
+    { "title", 0, 0, G_OPTION_ARG_STRING, &title, "Fixed track title", "TITLE" },
+    { NULL }
+  };
+
+  GError* error = NULL;
+  GOptionContext* context = g_option_context_new("- serve mock MPRIS players");
+  g_option_context_add_main_entries(context, entries, NULL);
+  if(!g_option_context_parse(context, &argc, &argv, &error) || !address){
+    g_printerr("%s\n", error ? error->message : "--address is required");
+    return 1;
+  }
+  g_option_context_free(context);
+
+  MockPlayerConfig config = {
+    .metadata_rate = metadata_rate,
+    .seeked_rate = seeked_rate,
+    .status_rate = status_rate,
+    .latency_ms = MAX(latency, 0),
+    .playing = playing,
+    .title = title,
+  };
+
+  GPtrArray* fleet = g_ptr_array_new_with_free_func((GDestroyNotify)mock_player_free);
+  for(gint i = 0; i < players; i++){
+    MockPlayer* player = mock_player_new(address, i, &config);
+    if(!player) return 1;
+    g_ptr_array_add(fleet, player);
+  }
+
+  printf("ready\n");
+  fflush(stdout);
+
+  GMainLoop* loop = g_main_loop_new(NULL, FALSE);
+  g_unix_fd_add(STDIN_FILENO, G_IO_IN | G_IO_HUP | G_IO_ERR, on_stdin, loop);
+  g_main_loop_run(loop);
+  g_main_loop_unref(loop);
+
+  guint64 signals = 0;
+  for(guint i = 0; i < fleet->len; i++) signals += mock_player_get_signals(g_ptr_array_index(fleet, i));
+  g_printerr("mock fleet: %u players sent %" G_GUINT64_FORMAT " signals\n", fleet->len, signals);
+
+  g_ptr_array_unref(fleet);
+  g_free(address);
+  g_free(title);
+  return 0;
+}
@@ -0,0 +1,499 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define G_LOG_DOMAIN "waybarmediaplayer.mock-player"
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#include "mock_player.h"
+
+#define MOCK_PATH         "/org/mpris/MediaPlayer2"
+#define MOCK_IFACE_ROOT   "org.mpris.MediaPlayer2"
+#define MOCK_IFACE_PLAYER "org.mpris.MediaPlayer2.Player"
+#define MOCK_IFACE_PROPS  "org.freedesktop.DBus.Properties"
+#define MOCK_TRACK_LENGTH (180 * G_USEC_PER_SEC)
+
+static const gchar mock_player_xml[] =
+  "<node>"
+  "  <interface name='org.mpris.MediaPlayer2'>"
+  "    <method name='Raise'/>"
+  "    <method name='Quit'/>"
+  "    <property name='CanQuit' type='b' access='read'/>"
+  "    <property name='CanRaise' type='b' access='read'/>"
+  "    <property name='HasTrackList' type='b' access='read'/>"
+  "    <property name='Identity' type='s' access='read'/>"
+  "    <property name='DesktopEntry' type='s' access='read'/>"
+  "    <property name='SupportedUriSchemes' type='as' access='read'/>"
+  "    <property name='SupportedMimeTypes' type='as' access='read'/>"
+  "  </interface>"
+  "  <interface name='org.mpris.MediaPlayer2.Player'>"
+  "    <method name='Next'/>"
+  "    <method name='Previous'/>"
+  "    <method name='Pause'/>"
+  "    <method name='PlayPause'/>"
+  "    <method name='Stop'/>"
+  "    <method name='Play'/>"
+  "    <method name='Seek'><arg direction='in' name='Offset' type='x'/></method>"
+  "    <method name='SetPosition'>"
+  "      <arg direction='in' name='TrackId' type='o'/>"
+  "      <arg direction='in' name='Position' type='x'/>"
+  "    </method>"
+  "    <signal name='Seeked'><arg name='Position' type='x'/></signal>"
+  "    <property name='PlaybackStatus' type='s' access='read'/>"
+  "    <property name='Rate' type='d' access='read'/>"
+  "    <property name='Metadata' type='a{sv}' access='read'/>"
+  "    <property name='Volume' type='d' access='readwrite'/>"
+  "    <property name='Position' type='x' access='read'/>"
+  "    <property name='MinimumRate' type='d' access='read'/>"
+  "    <property name='MaximumRate' type='d' access='read'/>"
+  "    <property name='CanGoNext' type='b' access='read'/>"
+  "    <property name='CanGoPrevious' type='b' access='read'/>"
+  "    <property name='CanPlay' type='b' access='read'/>"
+  "    <property name='CanPause' type='b' access='read'/>"
+  "    <property name='CanSeek' type='b' access='read'/>"
+  "    <property name='CanControl' type='b' access='read'/>"
+  "  </interface>"
+  "</node>";
+
+struct _MockPlayer
+{
+  GDBusConnection* conn;
+  gchar* bus_name;
+  guint index;
+  guint object_ids[2];
+
+  MockPlayerConfig config;
+  gchar* title;
+  guint track;
+  gboolean playing;
+  gdouble volume;
+  // Position at position_time, it only advances while playing
+  gint64 position;
+  gint64 position_time;
+
+  guint metadata_source;
+  guint seeked_source;
+  guint status_source;
+
+  // MockReply held back by the configured latency, oldest first
+  GQueue replies;
+
+  guint64 signals;
+};
+
+typedef struct _MockReply
+{
+  MockPlayer* player;
+  GDBusMethodInvocation* invocation;
+  guint source;
+} MockReply;
+
+static GDBusNodeInfo*
+mock_player_get_node_info(void){
+  static GDBusNodeInfo* info = NULL;
+
+  if(g_once_init_enter(&info)){
+    g_once_init_leave(&info, g_dbus_node_info_new_for_xml(mock_player_xml, NULL));
+  }
+  return info;
+}
+
+static gint64
+mock_player_get_position(MockPlayer* self){
+  gint64 position = self->position;
+  if(self->playing) position += g_get_monotonic_time() - self->position_time;
+  return CLAMP(position, 0, MOCK_TRACK_LENGTH);
+}
+
+static void
+mock_player_set_position_now(MockPlayer* self, gint64 position){
+  self->position = CLAMP(position, 0, MOCK_TRACK_LENGTH);
+  self->position_time = g_get_monotonic_time();
+}
+
+static GVariant*
+mock_player_build_metadata(MockPlayer* self){
+  GVariantBuilder builder;
+  g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+
+  gchar* track_id = g_strdup_printf(MOCK_PATH "/Track/%u", self->track);
+  gchar* artist = g_strdup_printf("Artist %u", self->index);
+  const gchar* artists[] = { artist, NULL };
+
+  g_variant_builder_add(&builder, "{sv}", "mpris:trackid", g_variant_new_object_path(track_id));
+  g_variant_builder_add(&builder, "{sv}", "mpris:length", g_variant_new_int64(MOCK_TRACK_LENGTH));
+  g_variant_builder_add(&builder, "{sv}", "xesam:title", g_variant_new_string(self->title));
+  g_variant_builder_add(&builder, "{sv}", "xesam:artist", g_variant_new_strv(artists, -1));
+  g_variant_builder_add(&builder, "{sv}", "xesam:album", g_variant_new_string("Mock Album"));
+  g_variant_builder_add(&builder, "{sv}", "xesam:trackNumber", g_variant_new_int32(self->track + 1));
+
+  g_free(track_id);
+  g_free(artist);
+
+  return g_variant_builder_end(&builder);
+}
+
+static GVariant*
+mock_player_get_all(MockPlayer* self, const gchar* iface){
+  GVariantBuilder builder;
+  g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+
+  if(g_strcmp0(iface, MOCK_IFACE_ROOT) == 0){
+    gchar* identity = g_strdup_printf("Mock %u", self->index);
+
+    g_variant_builder_add(&builder, "{sv}", "CanQuit", g_variant_new_boolean(FALSE));
+    g_variant_builder_add(&builder, "{sv}", "CanRaise", g_variant_new_boolean(TRUE));
+    g_variant_builder_add(&builder, "{sv}", "HasTrackList", g_variant_new_boolean(FALSE));
+    g_variant_builder_add(&builder, "{sv}", "Identity", g_variant_new_string(identity));
+    g_variant_builder_add(&builder, "{sv}", "DesktopEntry", g_variant_new_string("mock"));
+    g_variant_builder_add(&builder, "{sv}", "SupportedUriSchemes", g_variant_new_strv(NULL, 0));
+    g_variant_builder_add(&builder, "{sv}", "SupportedMimeTypes", g_variant_new_strv(NULL, 0));
+
+    g_free(identity);
+  } else if(g_strcmp0(iface, MOCK_IFACE_PLAYER) == 0){
+    g_variant_builder_add(&builder, "{sv}", "PlaybackStatus",
+                          g_variant_new_string(self->playing ? "Playing" : "Paused"));
+    g_variant_builder_add(&builder, "{sv}", "Rate", g_variant_new_double(1.0));
+    g_variant_builder_add(&builder, "{sv}", "Metadata", mock_player_build_metadata(self));
+    g_variant_builder_add(&builder, "{sv}", "Volume", g_variant_new_double(self->volume));
+    g_variant_builder_add(&builder, "{sv}", "Position", g_variant_new_int64(mock_player_get_position(self)));
+    g_variant_builder_add(&builder, "{sv}", "MinimumRate", g_variant_new_double(1.0));
+    g_variant_builder_add(&builder, "{sv}", "MaximumRate", g_variant_new_double(1.0));
+    g_variant_builder_add(&builder, "{sv}", "CanGoNext", g_variant_new_boolean(TRUE));
+    g_variant_builder_add(&builder, "{sv}", "CanGoPrevious", g_variant_new_boolean(TRUE));
+    g_variant_builder_add(&builder, "{sv}", "CanPlay", g_variant_new_boolean(TRUE));
+    g_variant_builder_add(&builder, "{sv}", "CanPause", g_variant_new_boolean(TRUE));
+    g_variant_builder_add(&builder, "{sv}", "CanSeek", g_variant_new_boolean(TRUE));
+    g_variant_builder_add(&builder, "{sv}", "CanControl", g_variant_new_boolean(TRUE));
+  }
+
+  return g_variant_builder_end(&builder);
+}
+
+static void
+mock_player_emit_changed(MockPlayer* self, const gchar* key, GVariant* value){
+  GVariantBuilder builder;
+  g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+  g_variant_builder_add(&builder, "{sv}", key, value);
+
+  g_dbus_connection_emit_signal(self->conn, NULL, MOCK_PATH, MOCK_IFACE_PROPS, "PropertiesChanged",
+                                g_variant_new("(sa{sv}as)", MOCK_IFACE_PLAYER, &builder, NULL),
+                                NULL);
+  self->signals++;
+}
+
+static void
+mock_player_emit_seeked(MockPlayer* self){
+  g_dbus_connection_emit_signal(self->conn, NULL, MOCK_PATH, MOCK_IFACE_PLAYER, "Seeked",
+                                g_variant_new("(x)", mock_player_get_position(self)),
+                                NULL);
+  self->signals++;
+}
+
+static void
+mock_player_change_track(MockPlayer* self, gint step){
+  self->track = step < 0 && self->track == 0 ? 0 : self->track + step;
+
+  if(!self->config.title){
+    g_free(self->title);
+    self->title = g_strdup_printf("Track %u", self->track);
+  }
+
+  mock_player_set_position_now(self, 0);
+  mock_player_emit_changed(self, "Metadata", mock_player_build_metadata(self));
+}
+
+static void
+mock_player_answer(MockPlayer* self, GDBusMethodInvocation* invocation){
+  const gchar* iface = g_dbus_method_invocation_get_interface_name(invocation);
+  const gchar* method = g_dbus_method_invocation_get_method_name(invocation);
+  GVariant* parameters = g_dbus_method_invocation_get_parameters(invocation);
+
+  if(g_strcmp0(iface, MOCK_IFACE_PROPS) == 0){
+    const gchar* target = NULL;
+    const gchar* name = NULL;
+
+    if(g_strcmp0(method, "GetAll") == 0){
+      g_variant_get(parameters, "(&s)", &target);
+      g_dbus_method_invocation_return_value(invocation,
+          g_variant_new("(@a{sv})", mock_player_get_all(self, target)));
+      return;
+    }
+
+    if(g_strcmp0(method, "Get") == 0){
+      g_variant_get(parameters, "(&s&s)", &target, &name);
+
+      GVariant* all = g_variant_ref_sink(mock_player_get_all(self, target));
+      GVariant* value = g_variant_lookup_value(all, name, NULL);
+      g_variant_unref(all);
+
+      if(!value){
+        g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_PROPERTY,
+                                              "No property %s on %s", name, target);
+        return;
+      }
+
+      g_dbus_method_invocation_return_value(invocation, g_variant_new("(v)", value));
+      g_variant_unref(value);
+      return;
+    }
+
+    if(g_strcmp0(method, "Set") == 0){
+      GVariant* value = NULL;
+      g_variant_get(parameters, "(&s&sv)", &target, &name, &value);
+
+      if(g_strcmp0(name, "Volume") == 0 && g_variant_is_of_type(value, G_VARIANT_TYPE_DOUBLE)){
+        self->volume = CLAMP(g_variant_get_double(value), 0.0, 1.0);
+        mock_player_emit_changed(self, "Volume", g_variant_new_double(self->volume));
+      }
+
+      g_variant_unref(value);
+      g_dbus_method_invocation_return_value(invocation, NULL);
+      return;
+    }
+  } else if(g_strcmp0(iface, MOCK_IFACE_PLAYER) == 0){
+    if(g_strcmp0(method, "Play") == 0){
+      mock_player_set_playing(self, TRUE);
+    } else if(g_strcmp0(method, "Pause") == 0 || g_strcmp0(method, "Stop") == 0){
+      mock_player_set_playing(self, FALSE);
+    } else if(g_strcmp0(method, "PlayPause") == 0){
+      mock_player_set_playing(self, !self->playing);
+    } else if(g_strcmp0(method, "Next") == 0){
+      mock_player_change_track(self, 1);
+    } else if(g_strcmp0(method, "Previous") == 0){
+      mock_player_change_track(self, -1);
+    } else if(g_strcmp0(method, "Seek") == 0){
+      gint64 offset = 0;
+      g_variant_get(parameters, "(x)", &offset);
+      mock_player_set_position_now(self, mock_player_get_position(self) + offset);
+      mock_player_emit_seeked(self);
+    } else if(g_strcmp0(method, "SetPosition") == 0){
+      const gchar* track_id = NULL;
+      gint64 position = 0;
+      g_variant_get(parameters, "(&ox)", &track_id, &position);
+      mock_player_set_position_now(self, position);
+      mock_player_emit_seeked(self);
+    }
+
+    g_dbus_method_invocation_return_value(invocation, NULL);
+    return;
+  }
+
+  // Raise and Quit do nothing
+  g_dbus_method_invocation_return_value(invocation, NULL);
+}
+
+static gboolean
+mock_player_reply_callback(gpointer user_data){
+  MockReply* reply = user_data;
+  MockPlayer* self = reply->player;
+
+  g_queue_remove(&self->replies, reply);
+  mock_player_answer(self, reply->invocation);
+  g_free(reply);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+mock_player_method_call(GDBusConnection* connection,
+                        const gchar* sender,
+                        const gchar* object_path,
+                        const gchar* interface_name,
+                        const gchar* method_name,
+                        GVariant* parameters,
+                        GDBusMethodInvocation* invocation,
+                        gpointer user_data){
+  MockPlayer* self = user_data;
+
+  if(self->config.latency_ms == 0){
+    mock_player_answer(self, invocation);
+    return;
+  }
+
+  MockReply* reply = g_new0(MockReply, 1);
+  reply->player = self;
+  reply->invocation = invocation;
+  reply->source = g_timeout_add(self->config.latency_ms, mock_player_reply_callback, reply);
+  g_queue_push_tail(&self->replies, reply);
+}
+
+// Property calls go to method_call as well, so they see the latency too
+static const GDBusInterfaceVTable mock_player_vtable = {
+  mock_player_method_call,
+  NULL,
+  NULL,
+  { 0 }
+};
+
+static gboolean
+mock_player_metadata_callback(gpointer user_data){
+  mock_player_change_track(user_data, 1);
+  return G_SOURCE_CONTINUE;
+}
+
+static gboolean
+mock_player_seeked_callback(gpointer user_data){
+  MockPlayer* self = user_data;
+
+  // Jump around inside the first minute
+  mock_player_set_position_now(self, g_random_int_range(0, 60) * G_USEC_PER_SEC);
+  mock_player_emit_seeked(self);
+  return G_SOURCE_CONTINUE;
+}
+
+static gboolean
+mock_player_status_callback(gpointer user_data){
+  MockPlayer* self = user_data;
+
+  mock_player_set_playing(self, !self->playing);
+  return G_SOURCE_CONTINUE;
+}
+
+static guint
+mock_player_add_rate(gdouble rate, GSourceFunc callback, MockPlayer* self){
+  if(rate <= 0) return 0;
+
+  return g_timeout_add(MAX((guint)(1000.0 / rate), 1), callback, self);
+}
+
+/*
+ * Serves one player on its own connection to the bus at bus_address, so
+ * the sender of its signals is told apart from the other mocks. The name
+ * is owned before this returns.
+ */
+MockPlayer*
+mock_player_new(const gchar* bus_address, guint index, const MockPlayerConfig* config){
+  GError* error = NULL;
+
+  GDBusConnection* conn = g_dbus_connection_new_for_address_sync(bus_address,
+      G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT | G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION,
+      NULL, NULL, &error);
+  if(!conn){
+    g_warning("Mock player %u can not connect: %s", index, error->message);
+    g_error_free(error);
+    return NULL;
+  }
+
+  MockPlayer* self = g_new0(MockPlayer, 1);
+  self->conn = conn;
+  self->index = index;
+  self->bus_name = g_strdup_printf(MOCK_PLAYER_NAME_PREFIX "%u", index);
+  self->config = *config;
+  self->config.title = NULL;
+  if(config->title) self->config.title = self->title = g_strdup(config->title);
+  else self->title = g_strdup("Track 0");
+  self->playing = config->playing;
+  self->volume = 0.5;
+  g_queue_init(&self->replies);
+  mock_player_set_position_now(self, 0);
+
+  GDBusNodeInfo* info = mock_player_get_node_info();
+  for(guint i = 0; i < G_N_ELEMENTS(self->object_ids); i++){
+    self->object_ids[i] = g_dbus_connection_register_object(conn, MOCK_PATH, info->interfaces[i],
+                                                            &mock_player_vtable, self, NULL, &error);
+    if(!self->object_ids[i]){
+      g_warning("Mock player %u can not export %s: %s", index, info->interfaces[i]->name, error->message);
+      g_clear_error(&error);
+    }
+  }
+
+  // DBUS_NAME_FLAG_DO_NOT_QUEUE, the name is ours or the call fails
+  GVariant* ret = g_dbus_connection_call_sync(conn, "org.freedesktop.DBus", "/org/freedesktop/DBus",
+                                              "org.freedesktop.DBus", "RequestName",
+                                              g_variant_new("(su)", self->bus_name, 4),
+                                              G_VARIANT_TYPE("(u)"), G_DBUS_CALL_FLAGS_NONE,
+                                              -1, NULL, &error);
+  guint32 result = 0;
+  if(ret){
+    g_variant_get(ret, "(u)", &result);
+    g_variant_unref(ret);
+  }
+  if(result != 1){
+    g_warning("Mock player %u can not own %s: %s", index, self->bus_name,
+              error ? error->message : "name taken");
+    g_clear_error(&error);
+  }
+
+  self->metadata_source = mock_player_add_rate(config->metadata_rate, mock_player_metadata_callback, self);
+  self->seeked_source = mock_player_add_rate(config->seeked_rate, mock_player_seeked_callback, self);
+  self->status_source = mock_player_add_rate(config->status_rate, mock_player_status_callback, self);
+
+  return self;
+}
+
+/*
+ * Drops the connection, the bus releases the name and announces it gone.
+ * Calls still held back are answered with an error.
+ */
+void
+mock_player_free(MockPlayer* self){
+  if(!self) return;
+
+  g_clear_handle_id(&self->metadata_source, g_source_remove);
+  g_clear_handle_id(&self->seeked_source, g_source_remove);
+  g_clear_handle_id(&self->status_source, g_source_remove);
+
+  MockReply* reply;
+  while((reply = g_queue_pop_head(&self->replies))){
+    g_source_remove(reply->source);
+    g_dbus_method_invocation_return_dbus_error(reply->invocation,
+        "org.freedesktop.DBus.Error.NoReply", "Mock player is going away");
+    g_free(reply);
+  }
+
+  for(guint i = 0; i < G_N_ELEMENTS(self->object_ids); i++){
+    if(self->object_ids[i]) g_dbus_connection_unregister_object(self->conn, self->object_ids[i]);
+  }
+
+  g_dbus_connection_close_sync(self->conn, NULL, NULL);
+  g_object_unref(self->conn);
+
+  g_free(self->title);
+  g_free(self->bus_name);
+  g_free(self);
+}
+
+const gchar*
+mock_player_get_bus_name(MockPlayer* self){
+  return self->bus_name;
+}
+
+guint64
+mock_player_get_signals(MockPlayer* self){
+  return self->signals;
+}
+
+void
+mock_player_set_playing(MockPlayer* self, gboolean playing){
+  if(self->playing == playing) return;
+
+  mock_player_set_position_now(self, mock_player_get_position(self));
+  self->playing = playing;
+  mock_player_emit_changed(self, "PlaybackStatus", g_variant_new_string(playing ? "Playing" : "Paused"));
+}
+
+// Pins the title, metadata churn keeps it from then on
+void
+mock_player_set_title(MockPlayer* self, const gchar* title){
+  g_free(self->title);
+  self->title = g_strdup(title);
+  self->config.title = self->title;
+
+  mock_player_emit_changed(self, "Metadata", mock_player_build_metadata(self));
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <glib.h>
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define MOCK_PLAYER_NAME_PREFIX "org.mpris.MediaPlayer2.mock"
+
+/*
+ * Behaviour of one mock player. Rates are per second, 0 turns the source
+ * off. latency_ms delays every method call and property read, replies are
+ * still answered in order.
+ */
+typedef struct _MockPlayerConfig
+{
+  gdouble metadata_rate;
+  gdouble seeked_rate;
+  gdouble status_rate;
+  guint latency_ms;
+
+  gboolean playing;
+  // Title of the first track, NULL for "Track 0"
+  const gchar* title;
+} MockPlayerConfig;
+
+typedef struct _MockPlayer MockPlayer;
+
+MockPlayer* mock_player_new(const gchar* bus_address, guint index, const MockPlayerConfig* config);
+void mock_player_free(MockPlayer* self);
+
+const gchar* mock_player_get_bus_name(MockPlayer* self);
+// Signals emitted since the player was created
+guint64 mock_player_get_signals(MockPlayer* self);
+
+void mock_player_set_playing(MockPlayer* self, gboolean playing);
+void mock_player_set_title(MockPlayer* self, const gchar* title);
+
+G_END_DECLS
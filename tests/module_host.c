@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include "module_host.h"
+
+gboolean
+module_host_init(gint* argc, gchar*** argv){
+  return gtk_init_check(argc, argv);
+}
+
+// obj is opaque to the module, the host passes itself
+static GtkContainer*
+module_host_get_root_widget(wbcffi_module* obj){
+  ModuleHost* self = (ModuleHost*)obj;
+  return GTK_CONTAINER(self->root);
+}
+
+static void
+module_host_queue_update(wbcffi_module* obj){
+}
+
+void
+module_host_load(ModuleHost* self, const wbcffi_config_entry* entries, gsize n_entries){
+  memset(self, 0, sizeof(ModuleHost));
+
+  self->window = gtk_offscreen_window_new();
+  self->root = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 0);
+  gtk_container_add(GTK_CONTAINER(self->window), self->root);
+
+  wbcffi_init_info info = {
+    .obj = (wbcffi_module*)self,
+    .waybar_version = "test",
+    .get_root_widget = module_host_get_root_widget,
+    .queue_update = module_host_queue_update,
+  };
+
+  self->instance = wbcffi_init(&info, entries, n_entries);
+  gtk_widget_show_all(self->window);
+}
+
+void
+module_host_unload(ModuleHost* self){
+  if(self->instance) wbcffi_deinit(self->instance);
+  self->instance = NULL;
+
+  g_clear_pointer(&self->window, gtk_widget_destroy);
+  self->root = NULL;
+}
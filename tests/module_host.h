@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <gtk/gtk.h>
+
+#include "waybar_cffi_module.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Loads the module through its CFFI entry points the way waybar does, into
+ * a box of an offscreen window. Needs a display, check module_host_init.
+ */
+typedef struct _ModuleHost
+{
+  GtkWidget* window;
+  GtkWidget* root;
+  void* instance;
+} ModuleHost;
+
+gboolean module_host_init(gint* argc, gchar*** argv);
+
+void module_host_load(ModuleHost* self, const wbcffi_config_entry* entries, gsize n_entries);
+void module_host_unload(ModuleHost* self);
+
+G_END_DECLS
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#include "harness.h"
+#include "mock_player.h"
+#include "mpris_media_manager.h"
+#include "mpris_media_player.h"
+
+/*
+ * Drives GMprisMediaManager against mock players on a private bus, no
+ * display needed.
+ */
+
+typedef struct
+{
+  Harness harness;
+  GMprisMediaManager* manager;
+  // Players the manager reported and has not removed yet
+  GPtrArray* players;
+  gboolean ready;
+  gboolean removed;
+  gboolean player_ready;
+} Fixture;
+
+static void
+on_player_ready(GMprisMediaPlayer* player, gpointer user_data){
+  Fixture* f = user_data;
+  f->player_ready = TRUE;
+}
+
+static void
+on_player_added(GMprisMediaManager* manager, GMprisMediaPlayer* player, gpointer user_data){
+  Fixture* f = user_data;
+
+  g_ptr_array_add(f->players, player);
+  g_signal_connect(player, "ready", G_CALLBACK(on_player_ready), f);
+}
+
+static void
+on_player_removed(GMprisMediaManager* manager, GMprisMediaPlayer* player, gpointer user_data){
+  Fixture* f = user_data;
+
+  g_signal_handlers_disconnect_by_data(player, f);
+  g_ptr_array_remove(f->players, player);
+  f->removed = TRUE;
+}
+
+static void
+on_ready(GMprisMediaManager* manager, gpointer user_data){
+  Fixture* f = user_data;
+  f->ready = TRUE;
+}
+
+static void
+fixture_setup(Fixture* f, gconstpointer data){
+  harness_up(&f->harness);
+
+  f->players = g_ptr_array_new();
+  f->manager = g_mpris_media_manager_new_for_connection(f->harness.conn);
+  g_signal_connect(f->manager, "player-added", G_CALLBACK(on_player_added), f);
+  g_signal_connect(f->manager, "player-removed", G_CALLBACK(on_player_removed), f);
+  g_signal_connect(f->manager, "ready", G_CALLBACK(on_ready), f);
+}
+
+static void
+fixture_teardown(Fixture* f, gconstpointer data){
+  for(guint i = 0; i < f->players->len; i++){
+    g_signal_handlers_disconnect_by_data(g_ptr_array_index(f->players, i), f);
+  }
+  g_clear_object(&f->manager);
+  g_ptr_array_unref(f->players);
+
+  harness_down(&f->harness);
+}
+
+static void
+test_listed_players(Fixture* f, gconstpointer data){
+  MockPlayerConfig config = { 0 };
+  MockPlayer* mocks[3];
+
+  for(guint i = 0; i < G_N_ELEMENTS(mocks); i++){
+    mocks[i] = mock_player_new(harness_get_address(&f->harness), i, &config);
+  }
+
+  g_mpris_media_manager_start(f->manager);
+  g_assert_true(harness_wait_for(&f->ready, 5000));
+
+  // Ready waits for the properties of every player found at start
+  g_assert_cmpuint(f->players->len, ==, G_N_ELEMENTS(mocks));
+  for(guint i = 0; i < f->players->len; i++){
+    GMprisMediaPlayer* player = g_ptr_array_index(f->players, i);
+
+    g_assert_cmpstr(g_mpris_media_player_get_title(player), ==, "Track 0");
+    g_assert_true(g_str_has_prefix(g_mpris_media_player_get_identity(player), "Mock "));
+  }
+
+  for(guint i = 0; i < G_N_ELEMENTS(mocks); i++) mock_player_free(mocks[i]);
+}
+
+static void
+test_player_removed(Fixture* f, gconstpointer data){
+  MockPlayerConfig config = { 0 };
+  MockPlayer* mock = mock_player_new(harness_get_address(&f->harness), 0, &config);
+
+  g_mpris_media_manager_start(f->manager);
+  g_assert_true(harness_wait_for(&f->ready, 5000));
+  g_assert_cmpuint(f->players->len, ==, 1);
+
+  mock_player_free(mock);
+
+  g_assert_true(harness_wait_for(&f->removed, 5000));
+  g_assert_cmpuint(f->players->len, ==, 0);
+}
+
+static void
+test_slow_late_player(Fixture* f, gconstpointer data){
+  g_mpris_media_manager_start(f->manager);
+  g_assert_true(harness_wait_for(&f->ready, 5000));
+  g_assert_cmpuint(f->players->len, ==, 0);
+
+  // Slow, but well inside the init deadline
+  MockPlayerConfig config = { .latency_ms = MPRIS_INIT_TIMEOUT_MS / 4 };
+  MockPlayer* mock = mock_player_new(harness_get_address(&f->harness), 0, &config);
+
+  g_assert_true(harness_wait_for(&f->player_ready, 5000));
+  g_assert_cmpuint(f->players->len, ==, 1);
+  g_assert_cmpstr(g_mpris_media_player_get_title(g_ptr_array_index(f->players, 0)), ==, "Track 0");
+
+  mock_player_free(mock);
+}
+
+static void
+test_metadata_churn(Fixture* f, gconstpointer data){
+  MockPlayerConfig config = { .metadata_rate = 20, .playing = TRUE };
+  MockPlayer* mock = mock_player_new(harness_get_address(&f->harness), 0, &config);
+
+  g_mpris_media_manager_start(f->manager);
+  g_assert_true(harness_wait_for(&f->ready, 5000));
+
+  // Changes over the event budget are merged, the newest still arrives
+  harness_run_for(1000);
+
+  const gchar* title = g_mpris_media_player_get_title(g_ptr_array_index(f->players, 0));
+  g_assert_true(g_str_has_prefix(title, "Track "));
+  g_assert_cmpstr(title, !=, "Track 0");
+
+  mock_player_free(mock);
+}
+
+int
+main(int argc, char** argv){
+  g_test_init(&argc, &argv, NULL);
+
+  g_test_add("/manager/listed-players", Fixture, NULL, fixture_setup, test_listed_players, fixture_teardown);
+  g_test_add("/manager/player-removed", Fixture, NULL, fixture_setup, test_player_removed, fixture_teardown);
+  g_test_add("/manager/slow-late-player", Fixture, NULL, fixture_setup, test_slow_late_player, fixture_teardown);
+  g_test_add("/manager/metadata-churn", Fixture, NULL, fixture_setup, test_metadata_churn, fixture_teardown);
+
+  return g_test_run();
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#include "harness.h"
+#include "mock_player.h"
+#include "mpris_media_manager.h"
+#include "mpris_media_player.h"
+
+/*
+ * Adds and removes batches of mock players while one manager keeps
+ * running. After every batch is gone the manager must hold no player, and
+ * neither the memory accounted to a batch nor RSS and the open fd count
+ * may grow from cycle to cycle.
+ */
+
+#define MEMORY_PLAYERS       8
+#define MEMORY_WARMUP_CYCLES 5
+#define MEMORY_CYCLES        100
+#define MEMORY_RSS_SLACK     (1024 * 1024)
+
+typedef struct
+{
+  Harness harness;
+  GMprisMediaManager* manager;
+  GPtrArray* players;
+  guint players_ready;
+  gboolean ready;
+} Fixture;
+
+static void
+on_player_ready(GMprisMediaPlayer* player, gpointer user_data){
+  Fixture* f = user_data;
+  f->players_ready++;
+}
+
+static void
+on_player_added(GMprisMediaManager* manager, GMprisMediaPlayer* player, gpointer user_data){
+  Fixture* f = user_data;
+
+  g_ptr_array_add(f->players, player);
+  g_signal_connect(player, "ready", G_CALLBACK(on_player_ready), f);
+}
+
+static void
+on_player_removed(GMprisMediaManager* manager, GMprisMediaPlayer* player, gpointer user_data){
+  Fixture* f = user_data;
+
+  g_signal_handlers_disconnect_by_data(player, f);
+  g_ptr_array_remove(f->players, player);
+}
+
+static void
+on_ready(GMprisMediaManager* manager, gpointer user_data){
+  Fixture* f = user_data;
+  f->ready = TRUE;
+}
+
+static void
+fixture_setup(Fixture* f, gconstpointer data){
+  harness_up(&f->harness);
+
+  f->players = g_ptr_array_new();
+  f->manager = g_mpris_media_manager_new_for_connection(f->harness.conn);
+  g_signal_connect(f->manager, "player-added", G_CALLBACK(on_player_added), f);
+  g_signal_connect(f->manager, "player-removed", G_CALLBACK(on_player_removed), f);
+  g_signal_connect(f->manager, "ready", G_CALLBACK(on_ready), f);
+
+  g_mpris_media_manager_start(f->manager);
+  g_assert_true(harness_wait_for(&f->ready, 5000));
+}
+
+static void
+fixture_teardown(Fixture* f, gconstpointer data){
+  for(guint i = 0; i < f->players->len; i++){
+    g_signal_handlers_disconnect_by_data(g_ptr_array_index(f->players, i), f);
+  }
+  g_clear_object(&f->manager);
+  g_ptr_array_unref(f->players);
+
+  harness_down(&f->harness);
+}
+
+// Runs the main context until the manager tracks players players
+static gboolean
+wait_for_players(Fixture* f, guint players){
+  gint64 deadline = g_get_monotonic_time() + 5 * G_USEC_PER_SEC;
+
+  while(g_get_monotonic_time() < deadline){
+    if(f->players->len == players && (!players || f->players_ready >= players)) return TRUE;
+    harness_run_for(10);
+  }
+  return FALSE;
+}
+
+// Adds a batch of players, returns the bytes accounted to them
+static gsize
+memory_cycle(Fixture* f){
+  MockPlayerConfig config = { .playing = TRUE };
+  MockPlayer* mocks[MEMORY_PLAYERS];
+  gsize total = 0;
+
+  f->players_ready = 0;
+  for(guint i = 0; i < MEMORY_PLAYERS; i++){
+    mocks[i] = mock_player_new(harness_get_address(&f->harness), i, &config);
+  }
+  g_assert_true(wait_for_players(f, MEMORY_PLAYERS));
+
+  for(guint i = 0; i < f->players->len; i++){
+    total += g_mpris_media_player_get_memory(g_ptr_array_index(f->players, i), NULL);
+  }
+
+  for(guint i = 0; i < MEMORY_PLAYERS; i++) mock_player_free(mocks[i]);
+  g_assert_true(wait_for_players(f, 0));
+
+  return total;
+}
+
+static void
+test_add_remove(Fixture* f, gconstpointer data){
+  gsize accounted = 0;
+
+  for(guint i = 0; i < MEMORY_WARMUP_CYCLES; i++) accounted = MAX(accounted, memory_cycle(f));
+
+  harness_run_for(200);
+  gsize rss = harness_get_rss();
+  guint fds = harness_count_fds();
+
+  for(guint i = 0; i < MEMORY_CYCLES; i++){
+    // Same players with the same tracks every cycle, nothing may pile up
+    g_assert_cmpuint(memory_cycle(f), <=, accounted);
+  }
+
+  harness_run_for(200);
+  gssize rss_growth = (gssize)harness_get_rss() - (gssize)rss;
+  guint fds_after = harness_count_fds();
+
+  g_test_message("%u players: %" G_GSIZE_FORMAT " bytes accounted, rss %+" G_GSSIZE_FORMAT
+                 " bytes over %u cycles, fds %u -> %u",
+                 MEMORY_PLAYERS, accounted, rss_growth, MEMORY_CYCLES, fds, fds_after);
+
+  g_assert_cmpuint(f->players->len, ==, 0);
+  g_assert_cmpuint(fds_after, ==, fds);
+  g_assert_cmpint(rss_growth, <=, MEMORY_RSS_SLACK);
+}
+
+int
+main(int argc, char** argv){
+  g_test_init(&argc, &argv, NULL);
+
+  g_test_add("/player-memory/add-remove", Fixture, NULL, fixture_setup, test_add_remove, fixture_teardown);
+
+  return g_test_run();
+}
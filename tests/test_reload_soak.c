@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <gtk/gtk.h>
+
+#include "harness.h"
+#include "module_host.h"
+#include "mock_player.h"
+#include "mpris_media_manager.h"
+
+/*
+ * Reload soak. Waybar loads and unloads the module on every config reload,
+ * so after a warm up RSS and the open fd count must stay flat over many
+ * cycles. SOAK_CYCLES overrides the number of measured cycles.
+ *
+ * Under AddressSanitizer the RSS check is skipped, its quarantine holds on
+ * to freed memory, and LeakSanitizer reports what was lost at exit:
+ *
+ *   meson setup build-asan -Db_sanitize=address
+ *   meson test -C build-asan reload-soak
+ */
+
+#if defined(__SANITIZE_ADDRESS__)
+#define SOAK_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define SOAK_ASAN 1
+#endif
+#endif
+
+#define SOAK_WARMUP_CYCLES   10
+#define SOAK_PLAYERS         3
+#define SOAK_RSS_SLACK       (1024 * 1024)
+// Time a loaded module gets to collect the players
+#define SOAK_MODULE_CYCLE_MS 100
+
+typedef struct
+{
+  Harness harness;
+  MockPlayer* mocks[SOAK_PLAYERS];
+} Fixture;
+
+typedef void (*SoakCycle)(Fixture* f);
+
+static gboolean display_available;
+
+static void
+fixture_setup(Fixture* f, gconstpointer data){
+  harness_up(&f->harness);
+
+  MockPlayerConfig config = { .playing = TRUE, .metadata_rate = 5 };
+  for(guint i = 0; i < SOAK_PLAYERS; i++){
+    f->mocks[i] = mock_player_new(harness_get_address(&f->harness), i, &config);
+  }
+}
+
+static void
+fixture_teardown(Fixture* f, gconstpointer data){
+  for(guint i = 0; i < SOAK_PLAYERS; i++) g_clear_pointer(&f->mocks[i], mock_player_free);
+  harness_down(&f->harness);
+}
+
+static guint
+soak_get_cycles(guint fallback){
+  const gchar* cycles = g_getenv("SOAK_CYCLES");
+  return cycles ? (guint)g_ascii_strtoull(cycles, NULL, 10) : fallback;
+}
+
+static void
+soak(Fixture* f, SoakCycle cycle, guint cycles){
+  for(guint i = 0; i < SOAK_WARMUP_CYCLES; i++) cycle(f);
+
+  // Replies to cancelled calls are still on their way after every cycle
+  harness_run_for(200);
+  gsize rss = harness_get_rss();
+  guint fds = harness_count_fds();
+
+  for(guint i = 0; i < cycles; i++) cycle(f);
+
+  harness_run_for(200);
+  gssize rss_growth = (gssize)harness_get_rss() - (gssize)rss;
+  guint fds_after = harness_count_fds();
+
+  g_test_message("%u cycles: rss %+" G_GSSIZE_FORMAT " bytes (%+.1f per cycle), fds %u -> %u",
+                 cycles, rss_growth, rss_growth / (gdouble)MAX(cycles, 1), fds, fds_after);
+
+  g_assert_cmpuint(fds_after, ==, fds);
+#ifndef SOAK_ASAN
+  g_assert_cmpint(rss_growth, <=, SOAK_RSS_SLACK);
+#endif
+}
+
+static void
+on_ready(GMprisMediaManager* manager, gpointer user_data){
+  *(gboolean*)user_data = TRUE;
+}
+
+static void
+manager_cycle(Fixture* f){
+  gboolean ready = FALSE;
+  GMprisMediaManager* manager = g_mpris_media_manager_new_for_connection(f->harness.conn);
+  g_signal_connect(manager, "ready", G_CALLBACK(on_ready), &ready);
+
+  g_mpris_media_manager_start(manager);
+  g_assert_true(harness_wait_for(&ready, 5000));
+
+  g_object_unref(manager);
+}
+
+static void
+module_cycle(Fixture* f){
+  ModuleHost host;
+
+  module_host_load(&host, NULL, 0);
+  harness_run_for(SOAK_MODULE_CYCLE_MS);
+  module_host_unload(&host);
+}
+
+static void
+test_manager(Fixture* f, gconstpointer data){
+  soak(f, manager_cycle, soak_get_cycles(300));
+}
+
+static void
+test_module(Fixture* f, gconstpointer data){
+  if(!display_available){
+    g_test_skip("No display");
+    return;
+  }
+
+  soak(f, module_cycle, soak_get_cycles(100));
+}
+
+int
+main(int argc, char** argv){
+  g_test_init(&argc, &argv, G_TEST_OPTION_ISOLATE_DIRS, NULL);
+  display_available = module_host_init(&argc, &argv);
+
+  g_test_add("/soak/manager", Fixture, NULL, fixture_setup, test_manager, fixture_teardown);
+  g_test_add("/soak/module", Fixture, NULL, fixture_setup, test_module, fixture_teardown);
+
+  return g_test_run();
+}
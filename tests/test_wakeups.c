@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2025 - Otávio Ribeiro <otavio@otavio.guru>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <gtk/gtk.h>
+
+#include "harness.h"
+#include "module_host.h"
+#include "mock_player.h"
+#include "mpris_media_manager.h"
+#include "media_stats.h"
+
+/*
+ * Wakeup budget. An idle bar must not wake the CPU at all, a playing
+ * player with a title that fits only ticks its position estimate.
+ *
+ * Every case runs twice: against the manager alone, which needs no
+ * display, and against the whole module loaded through its CFFI entry
+ * points, which is skipped without one.
+ */
+
+#define WAKEUP_SETTLE_MS  1500
+#define WAKEUP_WINDOW_MS  4000
+// Four position ticks a second, one to spare
+#define WAKEUP_PLAYING_PER_SECOND 5
+
+typedef enum
+{
+  WAKEUP_NO_PLAYER,
+  WAKEUP_PAUSED,
+  WAKEUP_PLAYING,
+} WakeupCase;
+
+typedef struct
+{
+  Harness harness;
+  MockPlayer* mock;
+} Fixture;
+
+static gboolean display_available;
+
+static GPollFunc default_poll;
+static guint64 polls;
+
+static gint
+counting_poll(GPollFD* fds, guint nfds, gint timeout){
+  polls++;
+  return default_poll(fds, nfds, timeout);
+}
+
+static void
+fixture_setup(Fixture* f, gconstpointer data){
+  WakeupCase wakeup_case = GPOINTER_TO_INT(data);
+
+  harness_up(&f->harness);
+
+  if(wakeup_case != WAKEUP_NO_PLAYER){
+    MockPlayerConfig config = {
+      .playing = wakeup_case == WAKEUP_PLAYING,
+      .title = "Song",
+    };
+    f->mock = mock_player_new(harness_get_address(&f->harness), 0, &config);
+  }
+}
+
+static void
+fixture_teardown(Fixture* f, gconstpointer data){
+  g_clear_pointer(&f->mock, mock_player_free);
+  harness_down(&f->harness);
+}
+
+static void
+on_ready(GMprisMediaManager* manager, gpointer user_data){
+  *(gboolean*)user_data = TRUE;
+}
+
+/*
+ * Counts timer wakeups of the module and main loop iterations over the
+ * window and checks them against the budget of the case.
+ */
+static void
+measure(WakeupCase wakeup_case){
+  guint64 timers = media_stats[MEDIA_STAT_TIMER_WAKEUPS];
+  polls = 0;
+
+  harness_run_for(WAKEUP_WINDOW_MS);
+
+  timers = media_stats[MEDIA_STAT_TIMER_WAKEUPS] - timers;
+  // The last iteration is the window's own timeout
+  guint64 wakeups = polls - 1;
+
+  g_test_message("timer wakeups=%" G_GUINT64_FORMAT " main loop wakeups=%" G_GUINT64_FORMAT
+                 " in %ums", timers, wakeups, WAKEUP_WINDOW_MS);
+
+  if(wakeup_case == WAKEUP_PLAYING){
+    g_assert_cmpuint(timers, >, 0);
+    g_assert_cmpuint(timers, <=, WAKEUP_PLAYING_PER_SECOND * WAKEUP_WINDOW_MS / 1000);
+  } else {
+    g_assert_cmpuint(timers, ==, 0);
+    g_assert_cmpuint(wakeups, ==, 0);
+  }
+}
+
+static void
+test_manager(Fixture* f, gconstpointer data){
+  gboolean ready = FALSE;
+  GMprisMediaManager* manager = g_mpris_media_manager_new_for_connection(f->harness.conn);
+  g_signal_connect(manager, "ready", G_CALLBACK(on_ready), &ready);
+
+  g_mpris_media_manager_start(manager);
+  g_assert_true(harness_wait_for(&ready, 5000));
+  harness_run_for(WAKEUP_SETTLE_MS);
+
+  measure(GPOINTER_TO_INT(data));
+
+  g_object_unref(manager);
+}
+
+static void
+test_module(Fixture* f, gconstpointer data){
+  if(!display_available){
+    g_test_skip("No display");
+    return;
+  }
+
+  // The module watches the session bus, GTestDBus points it at the harness
+  ModuleHost host;
+  module_host_load(&host, NULL, 0);
+  harness_run_for(WAKEUP_SETTLE_MS);
+
+  measure(GPOINTER_TO_INT(data));
+
+  module_host_unload(&host);
+}
+
+int
+main(int argc, char** argv){
+  g_test_init(&argc, &argv, G_TEST_OPTION_ISOLATE_DIRS, NULL);
+  display_available = module_host_init(&argc, &argv);
+
+  default_poll = g_main_context_get_poll_func(NULL);
+  g_main_context_set_poll_func(NULL, counting_poll);
+
+  static const struct
+  {
+    const gchar* name;
+    WakeupCase wakeup_case;
+  } cases[] = {
+    { "no-player", WAKEUP_NO_PLAYER },
+    { "paused", WAKEUP_PAUSED },
+    { "playing", WAKEUP_PLAYING },
+  };
+
+  for(guint i = 0; i < G_N_ELEMENTS(cases); i++){
+    gchar* path = g_strdup_printf("/wakeups/manager/%s", cases[i].name);
+    g_test_add(path, Fixture, GINT_TO_POINTER(cases[i].wakeup_case), fixture_setup, test_manager, fixture_teardown);
+    g_free(path);
+
+    path = g_strdup_printf("/wakeups/module/%s", cases[i].name);
+    g_test_add(path, Fixture, GINT_TO_POINTER(cases[i].wakeup_case), fixture_setup, test_module, fixture_teardown);
+    g_free(path);
+  }
+
+  return g_test_run();
+}
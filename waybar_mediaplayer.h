@@ -17,14 +17,29 @@
 #pragma once
 
 #include "waybar_cffi_module.h"
+#include "media_title_format.h"
 
 typedef struct _GtkMediaController GtkMediaController;
 
 typedef struct {
   wbcffi_module* waybar_module;
   GtkMediaController* container;
+  // Copied from the config, the controller owns the config
+  gint signal;
 } MediaPlayerMod;
 
+typedef enum {
+  TITLE_ELLIPSIZE_NONE,
+  TITLE_ELLIPSIZE_END,
+  TITLE_ELLIPSIZE_MIDDLE,
+} TitleEllipsize;
+
+typedef enum {
+  TIME_FORMAT_NONE,
+  TIME_FORMAT_ELAPSED,
+  TIME_FORMAT_REMAINING,
+} TimeFormat;
+
 typedef struct {
   gboolean scroll_title;
   gint title_max_width;
@@ -39,6 +54,25 @@ typedef struct {
   gchar* btn_prev;
   gchar* btn_next;
   gchar* ignored_players;
+  gint watchdog_threshold;
+  gchar* title_format;
+  // Compiled from title_format once at init
+  MediaTitleFormat* title_template;
+  // Pango span attributes per MediaTitleField, NULL when unstyled
+  gchar* title_styles[MEDIA_TITLE_FIELD_LAST];
+  // Shorten the title instead of scrolling it
+  TitleEllipsize title_ellipsize;
+  TimeFormat time_format;
+  gboolean player_icon;
+  gint player_icon_size;
+  // Seconds moved per horizontal scroll step over the title
+  gint seek_step;
+  // Volume percent changed per vertical scroll step over the module
+  gint volume_step;
+  // Position of this module among the loaded instances, keys its snapshot
+  guint instance;
+  // Waybar "signal" of the module, SIGRTMIN+signal dumps the counters, -1 when unset
+  gint signal;
 } MediaPlayerModConfig;
 
 